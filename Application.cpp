@@ -9,30 +9,49 @@
 
 Application::Application() : currentDateTime(time(0)) {}
 
+// Storage failures (a journal that cannot be written, a snapshot whose
+// checksum does not match, a lock that cannot be taken) surface as
+// exceptions; show them and return to the menu instead of terminating.
+void Application::showError(const std::exception& e) {
+    output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+    system("pause");
+}
+
 void Application::run() {
     bool running = true;
 
     while (running) {
-        loginSystem.run(loggedInUser);
+        try {
+            loginSystem.run(loggedInUser);
+        }
+        catch (const std::exception& e) {
+            showError(e);
+            continue;
+        }
 
         if (loggedInUser.userId.empty()) {
             running = false;
             break;
         }
 
-        switch (loggedInUser.userType) {
-        case UserType::ADMIN:
-            runAdminDashboard();
-            break;
-        case UserType::ORGANIZER:
-            runOrganizerDashboard();
-            break;
-        case UserType::CUSTOMER:
-            runCustomerDashboard();
-            break;
-        default:
-            output.println("Unknown user type! Logging out.", OutputManager::Color::RED);
-            break;
+        try {
+            switch (loggedInUser.userType) {
+            case UserType::ADMIN:
+                runAdminDashboard();
+                break;
+            case UserType::ORGANIZER:
+                runOrganizerDashboard();
+                break;
+            case UserType::CUSTOMER:
+                runCustomerDashboard();
+                break;
+            default:
+                output.println("Unknown user type! Logging out.", OutputManager::Color::RED);
+                break;
+            }
+        }
+        catch (const std::exception& e) {
+            showError(e);
         }
 
         output.println("Logging out...", OutputManager::Color::GREEN);
@@ -46,32 +65,37 @@ void Application::run() {
 void Application::runAdminDashboard() {
     bool shouldLogout = false;
     while (!shouldLogout) {
-        output.clearScreen();
-        output.printHeader("Admin Dashboard");
-        output.println("Welcome, " + loggedInUser.username + "!");
-        output.println("----------------------------------------");
-        output.println("1.  Manage User Accounts");
-        output.println("2.  Access Event Systems");
-        output.println("3.  Logout");
-        output.println("----------------------------------------");
-        output.print("Enter your choice (1-3): ");
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            loginSystem.manageUserAccounts();
-        }
-        else if (choice == "2") {
-            EventSystemMenu eventMenu;
-            eventMenu.run(loggedInUser, currentDateTime);
-        }
-        else if (choice == "3") {
-            shouldLogout = true;
-        }
-        else {
-            output.println("Invalid choice! Please select 1-3.", OutputManager::Color::RED);
-            system("pause");
+        try {
+            output.clearScreen();
+            output.printHeader("Admin Dashboard");
+            output.println("Welcome, " + loggedInUser.username + "!");
+            output.println("----------------------------------------");
+            output.println("1.  Manage User Accounts");
+            output.println("2.  Access Event Systems");
+            output.println("3.  Logout");
+            output.println("----------------------------------------");
+            output.print("Enter your choice (1-3): ");
+
+            std::string choice;
+            std::getline(std::cin, choice);
+
+            if (choice == "1") {
+                loginSystem.manageUserAccounts();
+            }
+            else if (choice == "2") {
+                EventSystemMenu eventMenu;
+                eventMenu.run(loggedInUser, currentDateTime);
+            }
+            else if (choice == "3") {
+                shouldLogout = true;
+            }
+            else {
+                output.println("Invalid choice! Please select 1-3.", OutputManager::Color::RED);
+                system("pause");
+            }
+        }
+        catch (const std::exception& e) {
+            showError(e);
         }
     }
 }
@@ -80,41 +104,47 @@ void Application::runOrganizerDashboard() {
     bool shouldLogout = false;
     dm.updateEventStatus(currentDateTime);
     while (!shouldLogout) {
-        output.clearScreen();
-        output.printHeader("Organizer Dashboard");
-        output.println("Welcome, " + loggedInUser.username + "!");
-        output.println("Current Date: " + TimeManagement::formatTimeTToString(currentDateTime, "%Y-%m-%d"));
-        output.println("Current Time: " + TimeManagement::formatTimeTToString(currentDateTime, "%H:%M"));
-        output.println("----------------------------------------");
-        output.println("1.  Create Event");
-        output.println("2.  Access Event Systems");
-        output.println("3.  Set Current Date and Time");
-        output.println("4.  Account Settings");
-        output.println("5.  Logout");
-        output.println("----------------------------------------");
-        output.print("Enter your choice (1-5): ");
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            EventRegistration::EventRegistration eventCreation(loggedInUser, currentDateTime);
-        }
-        else if (choice == "2") {
-            OrganizerDashboard::showAndManageOrganizerEvents(loggedInUser, currentDateTime, output, validation);
-        }
-        else if (choice == "3") {
-            eventManagement.getUserDateTimeInput(currentDateTime);
-        }
-        else if (choice == "4") {
-            loginSystem.userSettings();
-        }
-        else if (choice == "5") {
-            shouldLogout = true;
-        }
-        else {
-            output.println("Invalid choice! Please select 1-5.", OutputManager::Color::RED);
-            system("pause");
+        try {
+            dm.expireSeatHolds(currentDateTime);
+            output.clearScreen();
+            output.printHeader("Organizer Dashboard");
+            output.println("Welcome, " + loggedInUser.username + "!");
+            output.println("Current Date: " + TimeManagement::formatTimeTToString(currentDateTime, "%Y-%m-%d"));
+            output.println("Current Time: " + TimeManagement::formatTimeTToString(currentDateTime, "%H:%M"));
+            output.println("----------------------------------------");
+            output.println("1.  Create Event");
+            output.println("2.  Access Event Systems");
+            output.println("3.  Set Current Date and Time");
+            output.println("4.  Account Settings");
+            output.println("5.  Logout");
+            output.println("----------------------------------------");
+            output.print("Enter your choice (1-5): ");
+
+            std::string choice;
+            std::getline(std::cin, choice);
+
+            if (choice == "1") {
+                EventRegistration::EventRegistration eventCreation(loggedInUser, currentDateTime);
+            }
+            else if (choice == "2") {
+                OrganizerDashboard::showAndManageOrganizerEvents(loggedInUser, currentDateTime, output, validation);
+            }
+            else if (choice == "3") {
+                eventManagement.getUserDateTimeInput(currentDateTime);
+            }
+            else if (choice == "4") {
+                loginSystem.userSettings();
+            }
+            else if (choice == "5") {
+                shouldLogout = true;
+            }
+            else {
+                output.println("Invalid choice! Please select 1-5.", OutputManager::Color::RED);
+                system("pause");
+            }
+        }
+        catch (const std::exception& e) {
+            showError(e);
         }
     }
 }
@@ -123,53 +153,59 @@ void Application::runCustomerDashboard() {
     bool shouldLogout = false;
     dm.updateEventStatus(currentDateTime);
     while (!shouldLogout) {
-        output.clearScreen();
-        output.printHeader("Customer Dashboard");
-        output.println("Welcome, " + loggedInUser.username + "!");
-        output.println("Current Date: " + TimeManagement::formatTimeTToString(currentDateTime, "%Y-%m-%d"));
-        output.println("Current Time: " + TimeManagement::formatTimeTToString(currentDateTime, "%H:%M"));
-        output.println("----------------------------------------");
-        output.println("1.  Buy Ticket");
-        output.println("2.  Manage My Registered Events");
-        output.println("3.  Payment System");
-        output.println("4.  Vote System");
-        output.println("5.  Set Current Date and Time");
-        output.println("6.  Account Settings");
-        output.println("7.  Logout");
-        output.println("----------------------------------------");
-        output.print("Enter your choice (1-7): ");
-
-        std::string choice;
-        std::getline(std::cin, choice);
-
-        if (choice == "1") {
-            EventBooking::EventBooking eventBooking;
-            eventBooking.run(loggedInUser, currentDateTime);
-        }
-        else if (choice == "2") {
-            CustomerDashboard::showAndManageCustomerEvents(loggedInUser, currentDateTime, output, validation);
-        }
-        else if (choice == "3") {
-            PaymentCheckout::PaymentCheckout paymentSystem(loggedInUser, dm, currentDateTime);
-            paymentSystem.run();
-        }
-        else if (choice == "4") {
-            Voting::VoteSystem voteSystem(loggedInUser.userId, dm);
-            voteSystem.run(currentDateTime);
-
-        }
-        else if (choice == "5") {
-            eventManagement.getUserDateTimeInput(currentDateTime);
-        }
-        else if (choice == "6") {
-            loginSystem.userSettings();
-        }
-        else if (choice == "7") {
-            shouldLogout = true;
-        }
-        else {
-            output.println("Invalid choice! Please select 1-7.", OutputManager::Color::RED);
-            system("pause");
+        try {
+            dm.expireSeatHolds(currentDateTime);
+            output.clearScreen();
+            output.printHeader("Customer Dashboard");
+            output.println("Welcome, " + loggedInUser.username + "!");
+            output.println("Current Date: " + TimeManagement::formatTimeTToString(currentDateTime, "%Y-%m-%d"));
+            output.println("Current Time: " + TimeManagement::formatTimeTToString(currentDateTime, "%H:%M"));
+            output.println("----------------------------------------");
+            output.println("1.  Buy Ticket");
+            output.println("2.  Manage My Registered Events");
+            output.println("3.  Payment System");
+            output.println("4.  Vote System");
+            output.println("5.  Set Current Date and Time");
+            output.println("6.  Account Settings");
+            output.println("7.  Logout");
+            output.println("----------------------------------------");
+            output.print("Enter your choice (1-7): ");
+
+            std::string choice;
+            std::getline(std::cin, choice);
+
+            if (choice == "1") {
+                EventBooking::EventBooking eventBooking;
+                eventBooking.run(loggedInUser, currentDateTime);
+            }
+            else if (choice == "2") {
+                CustomerDashboard::showAndManageCustomerEvents(loggedInUser, currentDateTime, output, validation);
+            }
+            else if (choice == "3") {
+                PaymentCheckout::PaymentCheckout paymentSystem(loggedInUser, dm, currentDateTime);
+                paymentSystem.run();
+            }
+            else if (choice == "4") {
+                Voting::VoteSystem voteSystem(loggedInUser.userId, dm);
+                voteSystem.run(currentDateTime);
+
+            }
+            else if (choice == "5") {
+                eventManagement.getUserDateTimeInput(currentDateTime);
+            }
+            else if (choice == "6") {
+                loginSystem.userSettings();
+            }
+            else if (choice == "7") {
+                shouldLogout = true;
+            }
+            else {
+                output.println("Invalid choice! Please select 1-7.", OutputManager::Color::RED);
+                system("pause");
+            }
+        }
+        catch (const std::exception& e) {
+            showError(e);
         }
     }
 }
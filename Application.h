@@ -1,5 +1,6 @@
 #pragma once
 #include <ctime>
+#include <exception>
 #include "LoginModule.h"
 #include "OutputManager.h"
 #include "Validation.h"
@@ -28,4 +29,5 @@ private:
     void runAdminDashboard();
     void runOrganizerDashboard();
     void runCustomerDashboard();
+    void showError(const std::exception& e);
 };
\ No newline at end of file
@@ -51,13 +51,13 @@ namespace AttendanceManager {
     bool AttendanceManager::takeAttendance(Registration& registration) {
         try {
 
-            std::vector<Attendance> allAttendances = dm.loadData<Attendance>("attendances.json");
-            auto existingAttendance = std::find_if(allAttendances.begin(), allAttendances.end(),
+            std::vector<Attendance> registrationAttendances = dm.getAttendancesForRegistration(registration.registrationId);
+            auto existingAttendance = std::find_if(registrationAttendances.begin(), registrationAttendances.end(),
                 [&](const Attendance& att) {
-                    return att.registrationId == registration.registrationId && att.attendanceStatus == AttendanceStatus::PRESENT;
+                    return att.attendanceStatus == AttendanceStatus::PRESENT;
                 });
 
-            if (existingAttendance != allAttendances.end()) {
+            if (existingAttendance != registrationAttendances.end()) {
                 output.println("Attendance for this registration has already been marked as PRESENT.", OutputManager::Color::YELLOW);
                 system("pause");
                 return true;
@@ -108,28 +108,21 @@ namespace AttendanceManager {
     }
 
     void AttendanceManager::updateRegistrationStatus(Registration& registration) {
-        std::vector<Registration> allRegistraion = dm.loadData<Registration>("registrations.json");
-        auto it = std::find_if(allRegistraion.begin(), allRegistraion.end(),
-            [&](const Registration& reg) {
-                return reg.registrationId == registration.registrationId;
-            });
-        if (it != allRegistraion.end()) {
-            it->registrationStatus = RegistrationStatus::COMPLETED;
+        Registration storedRegistration = dm.getRegistrationFromRegistrationId(registration.registrationId);
+        if (!storedRegistration.registrationId.empty()) {
+            storedRegistration.registrationStatus = RegistrationStatus::COMPLETED;
+            dm.saveRecord(storedRegistration, dm.registrationFileName);
         }
-        dm.saveData(allRegistraion, "registrations.json");
     }
 
     void AttendanceManager::saveAttendance(const Registration& registration, AttendanceStatus status) {
         try {
-            std::vector<Attendance> allAttendances = dm.loadData<Attendance>("attendances.json");
+            std::vector<Attendance> existingAttendances = dm.getAttendancesForRegistration(registration.registrationId);
 
-            auto it = std::find_if(allAttendances.begin(), allAttendances.end(),
-                [&](const Attendance& att) {
-                    return att.registrationId == registration.registrationId;
-                });
-
-            if (it != allAttendances.end()) {
-                it->attendanceStatus = status;
+            if (!existingAttendances.empty()) {
+                Attendance existing = existingAttendances.front();
+                existing.attendanceStatus = status;
+                dm.saveRecord(existing, dm.attendanceFileName);
                 output.println("Updated existing attendance record.", OutputManager::Color::BLUE);
             }
             else {
@@ -139,12 +132,10 @@ namespace AttendanceManager {
                 newAttendance.attendanceTime = time(nullptr);
                 newAttendance.attendanceStatus = status;
 
-                allAttendances.push_back(newAttendance);
+                dm.saveRecord(newAttendance, dm.attendanceFileName);
                 output.println("Created new attendance record.", OutputManager::Color::BLUE);
             }
 
-            dm.saveData(allAttendances, "attendances.json");
-
         }
         catch (const std::exception& e) {
             output.println("Error saving attendance: " + std::string(e.what()), OutputManager::Color::RED);
@@ -0,0 +1,54 @@
+#include "AudienceCounts.h"
+
+const std::string AudienceCounts::ALL_EVENTS = "*";
+
+void AudienceCounts::clear() {
+    voters.clear();
+    attendees.clear();
+    loaded = false;
+}
+
+void AudienceCounts::addVoter(const std::string& eventId, const std::string& customerId) {
+    add(voters, eventId, customerId);
+}
+
+void AudienceCounts::addAttendee(const std::string& eventId, const std::string& customerId) {
+    add(attendees, eventId, customerId);
+}
+
+long long AudienceCounts::uniqueVoters(const std::string& eventId) const {
+    return unique(voters, eventId);
+}
+
+long long AudienceCounts::uniqueAttendees(const std::string& eventId) const {
+    return unique(attendees, eventId);
+}
+
+long long AudienceCounts::uniqueVoters(const std::vector<std::string>& eventIds) const {
+    return unique(voters, eventIds);
+}
+
+long long AudienceCounts::uniqueAttendees(const std::vector<std::string>& eventIds) const {
+    return unique(attendees, eventIds);
+}
+
+void AudienceCounts::add(Sketches& sketches, const std::string& eventId, const std::string& customerId) {
+    sketches[eventId].add(customerId);
+    sketches[ALL_EVENTS].add(customerId);
+}
+
+long long AudienceCounts::unique(const Sketches& sketches, const std::string& eventId) {
+    auto it = sketches.find(eventId);
+    return it == sketches.end() ? 0 : it->second.count();
+}
+
+long long AudienceCounts::unique(const Sketches& sketches, const std::vector<std::string>& eventIds) {
+    HyperLogLog merged;
+    for (const auto& eventId : eventIds) {
+        auto it = sketches.find(eventId);
+        if (it != sketches.end()) {
+            merged.merge(it->second);
+        }
+    }
+    return merged.count();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "HyperLogLog.h"
+
+// Distinct customers who voted at, or attended, each event, kept as
+// HyperLogLog sketches so each event costs the same few kilobytes however
+// many people come. Totals over all events sit under ALL_EVENTS, and the
+// per-event sketches merge for any other set of events. A customer stays
+// counted once seen; refunds and deletions do not take them back out.
+class AudienceCounts {
+public:
+    static const std::string ALL_EVENTS;
+
+    bool isLoaded() const { return loaded; }
+    void markLoaded() { loaded = true; }
+    void clear();
+
+    void addVoter(const std::string& eventId, const std::string& customerId);
+    void addAttendee(const std::string& eventId, const std::string& customerId);
+
+    long long uniqueVoters(const std::string& eventId) const;
+    long long uniqueAttendees(const std::string& eventId) const;
+    // Customers counted at any of the events, each once.
+    long long uniqueVoters(const std::vector<std::string>& eventIds) const;
+    long long uniqueAttendees(const std::vector<std::string>& eventIds) const;
+
+private:
+    typedef std::unordered_map<std::string, HyperLogLog> Sketches;
+
+    bool loaded = false;
+    Sketches voters;
+    Sketches attendees;
+
+    static void add(Sketches& sketches, const std::string& eventId, const std::string& customerId);
+    static long long unique(const Sketches& sketches, const std::string& eventId);
+    static long long unique(const Sketches& sketches, const std::vector<std::string>& eventIds);
+};
@@ -0,0 +1,168 @@
+#include "BinarySnapshot.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace BinarySnapshot {
+
+    static const char MAGIC[4] = { 'N', 'M', 'A', 'B' };
+
+    void Writer::putLittleEndian(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void Writer::putUInt8(uint8_t value) {
+        putLittleEndian(value, 1);
+    }
+
+    void Writer::putUInt16(uint16_t value) {
+        putLittleEndian(value, 2);
+    }
+
+    void Writer::putUInt32(uint32_t value) {
+        putLittleEndian(value, 4);
+    }
+
+    void Writer::putInt64(int64_t value) {
+        putLittleEndian(static_cast<uint64_t>(value), 8);
+    }
+
+    void Writer::putDouble(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putLittleEndian(bits, 8);
+    }
+
+    void Writer::putString(const std::string& value) {
+        putUInt32(static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    const std::string& Writer::data() const {
+        return buffer;
+    }
+
+    Reader::Reader(std::string_view data) : data(data) {
+    }
+
+    void Reader::require(size_t bytes) {
+        if (data.size() - position < bytes) {
+            throw std::runtime_error("Binary snapshot is truncated.");
+        }
+    }
+
+    uint64_t Reader::getLittleEndian(int bytes) {
+        require(bytes);
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(data[position + i])) << (8 * i);
+        }
+        position += bytes;
+        return value;
+    }
+
+    uint8_t Reader::getUInt8() {
+        return static_cast<uint8_t>(getLittleEndian(1));
+    }
+
+    uint16_t Reader::getUInt16() {
+        return static_cast<uint16_t>(getLittleEndian(2));
+    }
+
+    uint32_t Reader::getUInt32() {
+        return static_cast<uint32_t>(getLittleEndian(4));
+    }
+
+    int64_t Reader::getInt64() {
+        return static_cast<int64_t>(getLittleEndian(8));
+    }
+
+    double Reader::getDouble() {
+        uint64_t bits = getLittleEndian(8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string Reader::getString() {
+        return std::string(getText());
+    }
+
+    std::string_view Reader::getText() {
+        uint32_t length = getUInt32();
+        require(length);
+        std::string_view value = data.substr(position, length);
+        position += length;
+        return value;
+    }
+
+    size_t Reader::tell() const {
+        return position;
+    }
+
+    void Reader::seek(size_t offset) {
+        if (offset > data.size()) {
+            throw std::runtime_error("Binary snapshot is truncated.");
+        }
+        position = offset;
+    }
+
+    void Reader::skip(size_t bytes) {
+        require(bytes);
+        position += bytes;
+    }
+
+    // Every row takes at least one byte, so a count larger than the remaining
+    // data can only come from a damaged file.
+    uint32_t Reader::getCount() {
+        uint32_t count = getUInt32();
+        if (count > data.size() - position) {
+            throw std::runtime_error("Binary snapshot is truncated.");
+        }
+        return count;
+    }
+
+    bool Reader::atEnd() const {
+        return position == data.size();
+    }
+
+    uint16_t Reader::version() const {
+        return schemaVersion;
+    }
+
+    void Reader::setVersion(uint16_t version) {
+        schemaVersion = version;
+    }
+
+    void writeHeader(Writer& out, const char* entityName, uint32_t rowCount) {
+        for (char c : MAGIC) {
+            out.putUInt8(static_cast<uint8_t>(c));
+        }
+        out.putUInt16(SCHEMA_VERSION);
+        out.putString(entityName);
+        out.putUInt32(rowCount);
+    }
+
+    uint32_t readHeader(Reader& in, const char* entityName) {
+        for (char c : MAGIC) {
+            if (in.getUInt8() != static_cast<uint8_t>(c)) {
+                throw std::runtime_error("Not a binary snapshot.");
+            }
+        }
+        uint16_t version = in.getUInt16();
+        if (version == 0 || version > SCHEMA_VERSION) {
+            throw std::runtime_error("Unsupported binary snapshot version " + std::to_string(version) + ".");
+        }
+        in.setVersion(version);
+        std::string name = in.getString();
+        if (name != entityName) {
+            throw std::runtime_error("Binary snapshot holds " + name + " records, expected " + entityName + ".");
+        }
+        return in.getCount();
+    }
+
+    bool isBinarySnapshot(std::string_view contents) {
+        return contents.size() >= sizeof(MAGIC) && std::memcmp(contents.data(), MAGIC, sizeof(MAGIC)) == 0;
+    }
+}
@@ -0,0 +1,535 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <ctime>
+#include <stdexcept>
+#include <type_traits>
+#include "Model.h"
+
+// Compact column-oriented snapshot format. A file starts with a magic number,
+// the schema version, the entity name and the row count; every field is then
+// stored as one column holding that field for all rows. Strings are length
+// prefixed, time_t is a fixed 64-bit value and enums are fixed 32-bit values.
+// Fields added in a later schema version are appended to their Schema and
+// listed in SchemaHistory, so files written by older versions still load.
+namespace BinarySnapshot {
+    const uint16_t SCHEMA_VERSION = 3;
+
+    class Writer {
+    public:
+        void putUInt8(uint8_t value);
+        void putUInt16(uint16_t value);
+        void putUInt32(uint32_t value);
+        void putInt64(int64_t value);
+        void putDouble(double value);
+        void putString(const std::string& value);
+        const std::string& data() const;
+
+    private:
+        std::string buffer;
+        void putLittleEndian(uint64_t value, int bytes);
+    };
+
+    class Reader {
+    public:
+        explicit Reader(std::string_view data);
+        uint8_t getUInt8();
+        uint16_t getUInt16();
+        uint32_t getUInt32();
+        int64_t getInt64();
+        double getDouble();
+        std::string getString();
+        std::string_view getText();
+        uint32_t getCount();
+        size_t tell() const;
+        void seek(size_t offset);
+        void skip(size_t bytes);
+        bool atEnd() const;
+        uint16_t version() const;
+        void setVersion(uint16_t schemaVersion);
+
+    private:
+        std::string_view data;
+        size_t position = 0;
+        uint16_t schemaVersion = SCHEMA_VERSION;
+        uint64_t getLittleEndian(int bytes);
+        void require(size_t bytes);
+    };
+
+    void writeHeader(Writer& out, const char* entityName, uint32_t rowCount);
+    uint32_t readHeader(Reader& in, const char* entityName);
+    bool isBinarySnapshot(std::string_view contents);
+
+    template <typename T>
+    struct Schema;
+
+    template <>
+    struct Schema<User> {
+        static const char* name() { return "User"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("userId", &User::userId);
+            field("username", &User::username);
+            field("passwordHash", &User::passwordHash);
+            field("email", &User::email);
+            field("phoneNumber", &User::phoneNumber);
+            field("userType", &User::userType);
+            field("isDeleted", &User::isDeleted);
+        }
+    };
+
+    template <>
+    struct Schema<VenueSection> {
+        static const char* name() { return "VenueSection"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("name", &VenueSection::name);
+            field("rows", &VenueSection::rows);
+            field("seatsPerRow", &VenueSection::seatsPerRow);
+        }
+    };
+
+    template <>
+    struct Schema<Event> {
+        static const char* name() { return "Event"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("eventId", &Event::eventId);
+            field("eventName", &Event::eventName);
+            field("description", &Event::description);
+            field("eventDate", &Event::eventDate);
+            field("startTime", &Event::startTime);
+            field("endTime", &Event::endTime);
+            field("organizerId", &Event::organizerId);
+            field("ticketPrice", &Event::ticketPrice);
+            field("status", &Event::status);
+            field("totalSeats", &Event::totalSeats);
+            field("isDeleted", &Event::isDeleted);
+            field("sections", &Event::sections);
+        }
+    };
+
+    template <>
+    struct Schema<Seat> {
+        static const char* name() { return "Seat"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("seatId", &Seat::seatId);
+            field("row", &Seat::row);
+            field("column", &Seat::column);
+            field("registrationId", &Seat::registrationId);
+            field("status", &Seat::status);
+        }
+    };
+
+    template <>
+    struct Schema<Registration> {
+        static const char* name() { return "Registration"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("registrationId", &Registration::registrationId);
+            field("customerId", &Registration::customerId);
+            field("eventId", &Registration::eventId);
+            field("seats", &Registration::seats);
+            field("registerTime", &Registration::registerTime);
+            field("registrationStatus", &Registration::registrationStatus);
+            field("isDeleted", &Registration::isDeleted);
+        }
+    };
+
+    template <>
+    struct Schema<Payment> {
+        static const char* name() { return "Payment"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("paymentId", &Payment::paymentId);
+            field("registrationId", &Payment::registrationId);
+            field("amount", &Payment::amount);
+            field("paymentDate", &Payment::paymentDate);
+            field("paymentMethod", &Payment::paymentMethod);
+            field("paymentStatus", &Payment::paymentStatus);
+            field("isDeleted", &Payment::isDeleted);
+        }
+    };
+
+    template <>
+    struct Schema<Refund> {
+        static const char* name() { return "Refund"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("refundId", &Refund::refundId);
+            field("paymentId", &Refund::paymentId);
+            field("refundAmount", &Refund::refundAmount);
+            field("refundDate", &Refund::refundDate);
+            field("reason", &Refund::reason);
+            field("isDeleted", &Refund::isDeleted);
+        }
+    };
+
+    template <>
+    struct Schema<Song> {
+        static const char* name() { return "Song"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("songId", &Song::songId);
+            field("title", &Song::title);
+        }
+    };
+
+    template <>
+    struct Schema<Performance> {
+        static const char* name() { return "Performance"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("performanceId", &Performance::performanceId);
+            field("eventId", &Performance::eventId);
+            field("performerName", &Performance::performerName);
+            field("songs", &Performance::songs);
+            field("startTime", &Performance::startTime);
+            field("endTime", &Performance::endTime);
+            field("isDeleted", &Performance::isDeleted);
+        }
+    };
+
+    template <>
+    struct Schema<Vote> {
+        static const char* name() { return "Vote"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("voteId", &Vote::voteId);
+            field("songId", &Vote::songId);
+            field("registrationId", &Vote::registrationId);
+            field("voteWeight", &Vote::voteWeight);
+            field("isDeleted", &Vote::isDeleted);
+            field("voteTime", &Vote::voteTime);
+        }
+    };
+
+    template <>
+    struct Schema<Attendance> {
+        static const char* name() { return "Attendance"; }
+        template <typename Visit>
+        static void fields(Visit&& field) {
+            field("attendanceId", &Attendance::attendanceId);
+            field("registrationId", &Attendance::registrationId);
+            field("attendanceStatus", &Attendance::attendanceStatus);
+            field("attendanceTime", &Attendance::attendanceTime);
+            field("isDeleted", &Attendance::isDeleted);
+        }
+    };
+
+    // Number of leading Schema<T> fields stored by files of the given version.
+    template <typename T>
+    struct SchemaHistory {
+        static size_t fieldCount(uint16_t) { return SIZE_MAX; }
+    };
+
+    template <>
+    struct SchemaHistory<Event> {
+        static size_t fieldCount(uint16_t version) { return version < 2 ? 11 : SIZE_MAX; }
+    };
+
+    template <>
+    struct SchemaHistory<Vote> {
+        static size_t fieldCount(uint16_t version) { return version < 3 ? 5 : SIZE_MAX; }
+    };
+
+    // Visits the fields of T that a file of the given version holds.
+    template <typename T, typename Visit>
+    void storedFields(uint16_t version, Visit&& visit) {
+        size_t limit = SchemaHistory<T>::fieldCount(version);
+        size_t index = 0;
+        Schema<T>::fields([&](const char* name, auto member) {
+            if (index++ < limit) {
+                visit(name, member);
+            }
+        });
+    }
+
+    template <typename T>
+    void writeColumns(Writer& out, const std::vector<T>& rows);
+    template <typename T>
+    void readColumns(Reader& in, std::vector<T>& rows);
+
+    inline void writeField(Writer& out, const std::string& value) { out.putString(value); }
+    inline void writeField(Writer& out, bool value) { out.putUInt8(value ? 1 : 0); }
+    inline void writeField(Writer& out, int value) { out.putUInt32(static_cast<uint32_t>(value)); }
+    inline void writeField(Writer& out, double value) { out.putDouble(value); }
+    inline void writeField(Writer& out, time_t value) { out.putInt64(static_cast<int64_t>(value)); }
+
+    template <typename E>
+    typename std::enable_if<std::is_enum<E>::value>::type writeField(Writer& out, E value) {
+        out.putUInt32(static_cast<uint32_t>(value));
+    }
+
+    template <typename T>
+    void writeField(Writer& out, const std::vector<T>& values) {
+        out.putUInt32(static_cast<uint32_t>(values.size()));
+        writeColumns(out, values);
+    }
+
+    inline void readField(Reader& in, std::string& value) { value = in.getString(); }
+    inline void readField(Reader& in, bool& value) { value = in.getUInt8() != 0; }
+    inline void readField(Reader& in, int& value) { value = static_cast<int>(in.getUInt32()); }
+    inline void readField(Reader& in, double& value) { value = in.getDouble(); }
+    inline void readField(Reader& in, time_t& value) { value = static_cast<time_t>(in.getInt64()); }
+
+    template <typename E>
+    typename std::enable_if<std::is_enum<E>::value>::type readField(Reader& in, E& value) {
+        value = static_cast<E>(in.getUInt32());
+    }
+
+    template <typename T>
+    void readField(Reader& in, std::vector<T>& values) {
+        values.resize(in.getCount());
+        readColumns(in, values);
+    }
+
+    template <typename T>
+    void writeColumns(Writer& out, const std::vector<T>& rows) {
+        Schema<T>::fields([&](const char*, auto member) {
+            for (const T& row : rows) {
+                writeField(out, row.*member);
+            }
+        });
+    }
+
+    template <typename T>
+    void readColumns(Reader& in, std::vector<T>& rows) {
+        storedFields<T>(in.version(), [&](const char*, auto member) {
+            for (T& row : rows) {
+                readField(in, row.*member);
+            }
+        });
+    }
+
+    template <typename T>
+    std::string encode(const std::vector<T>& rows) {
+        Writer out;
+        writeHeader(out, Schema<T>::name(), static_cast<uint32_t>(rows.size()));
+        writeColumns(out, rows);
+        return out.data();
+    }
+
+    // Throws std::runtime_error when the data is not a complete snapshot of T.
+    template <typename T>
+    std::vector<T> decode(const std::string& contents) {
+        Reader in(contents);
+        std::vector<T> rows(readHeader(in, Schema<T>::name()));
+        readColumns(in, rows);
+        if (!in.atEnd()) {
+            throw std::runtime_error(std::string("Unexpected data after ") + Schema<T>::name() + " snapshot.");
+        }
+        return rows;
+    }
+
+    template <typename F, typename = void>
+    struct FixedWidth { static const size_t value = 0; };
+    template <> struct FixedWidth<bool> { static const size_t value = 1; };
+    template <> struct FixedWidth<int> { static const size_t value = 4; };
+    template <> struct FixedWidth<double> { static const size_t value = 8; };
+    template <> struct FixedWidth<time_t> { static const size_t value = 8; };
+    template <typename F>
+    struct FixedWidth<F, typename std::enable_if<std::is_enum<F>::value>::type> { static const size_t value = 4; };
+
+    template <typename M>
+    struct MemberType;
+    template <typename C, typename F>
+    struct MemberType<F C::*> { using type = F; };
+
+    template <typename F>
+    struct ListElement { using type = void; };
+    template <typename U>
+    struct ListElement<std::vector<U>> { using type = U; };
+
+    // Steps over rowCount rows of T's columns without reading them.
+    template <typename T>
+    void skipColumns(Reader& in, size_t rowCount) {
+        storedFields<T>(in.version(), [&](const char*, auto member) {
+            using F = typename MemberType<decltype(member)>::type;
+            if constexpr (FixedWidth<F>::value > 0) {
+                in.skip(FixedWidth<F>::value * rowCount);
+            }
+            else if constexpr (std::is_same<F, std::string>::value) {
+                for (size_t row = 0; row < rowCount; ++row) {
+                    in.skip(in.getUInt32());
+                }
+            }
+            else {
+                for (size_t row = 0; row < rowCount; ++row) {
+                    skipColumns<typename ListElement<F>::type>(in, in.getCount());
+                }
+            }
+        });
+    }
+
+    // Read-only view over encoded rows of T that reads fields in place. Only the
+    // start of each column and the offset of each variable-width value are kept;
+    // strings come back as views into the encoded data, which must outlive the view.
+    template <typename T>
+    class TableView {
+    public:
+        TableView() = default;
+
+        // Throws std::runtime_error when the data is not a complete snapshot of T.
+        explicit TableView(std::string_view contents) : data(contents) {
+            Reader in(data);
+            rowCount = readHeader(in, Schema<T>::name());
+            version = in.version();
+            indexColumns(in);
+            if (!in.atEnd()) {
+                throw std::runtime_error(std::string("Unexpected data after ") + Schema<T>::name() + " snapshot.");
+            }
+        }
+
+        // Nested rows stored at position without a header, as for Registration::seats.
+        TableView(std::string_view contents, size_t position, uint32_t rows, uint16_t schemaVersion)
+            : data(contents), rowCount(rows), version(schemaVersion) {
+            Reader in(data);
+            in.setVersion(version);
+            in.seek(position);
+            indexColumns(in);
+        }
+
+        size_t size() const {
+            return rowCount;
+        }
+
+        std::string_view text(size_t row, std::string T::* field) const {
+            Reader in(data);
+            in.seek(columns[columnOf(field)].offsets[row]);
+            return in.getText();
+        }
+
+        template <typename F>
+        F value(size_t row, F T::* field) const {
+            static_assert(FixedWidth<F>::value > 0, "value() reads fixed-width fields only");
+            Reader in(data);
+            in.seek(columns[columnOf(field)].start + row * FixedWidth<F>::value);
+            F result;
+            readField(in, result);
+            return result;
+        }
+
+        template <typename U>
+        TableView<U> list(size_t row, std::vector<U> T::* field) const {
+            Reader in(data);
+            in.seek(columns[columnOf(field)].offsets[row]);
+            uint32_t count = in.getCount();
+            return TableView<U>(data, in.tell(), count, version);
+        }
+
+        // Builds a full copy of one row.
+        T record(size_t row) const {
+            T result;
+            size_t index = 0;
+            storedFields<T>(version, [&](const char*, auto member) {
+                using F = typename MemberType<decltype(member)>::type;
+                const Column& column = columns[index++];
+                Reader in(data);
+                if constexpr (FixedWidth<F>::value > 0) {
+                    in.seek(column.start + row * FixedWidth<F>::value);
+                    readField(in, result.*member);
+                }
+                else if constexpr (std::is_same<F, std::string>::value) {
+                    in.seek(column.offsets[row]);
+                    result.*member = in.getString();
+                }
+                else {
+                    using U = typename ListElement<F>::type;
+                    in.seek(column.offsets[row]);
+                    uint32_t count = in.getCount();
+                    TableView<U> nested(data, in.tell(), count, version);
+                    (result.*member).reserve(count);
+                    for (size_t nestedRow = 0; nestedRow < count; ++nestedRow) {
+                        (result.*member).push_back(nested.record(nestedRow));
+                    }
+                }
+            });
+            return result;
+        }
+
+        // Copies of the rows whose string field equals value; other rows are not built.
+        std::vector<T> rowsWhere(const std::string& field, const std::string& value) const {
+            const Column* match = nullptr;
+            size_t index = 0;
+            storedFields<T>(version, [&](const char* name, auto member) {
+                using F = typename MemberType<decltype(member)>::type;
+                if (std::is_same<F, std::string>::value && field == name) {
+                    match = &columns[index];
+                }
+                ++index;
+            });
+            if (!match) {
+                throw std::invalid_argument(std::string(Schema<T>::name()) + " has no text field " + field + ".");
+            }
+
+            std::vector<T> rows;
+            for (size_t row = 0; row < rowCount; ++row) {
+                Reader in(data);
+                in.seek(match->offsets[row]);
+                if (in.getText() == value) {
+                    rows.push_back(record(row));
+                }
+            }
+            return rows;
+        }
+
+    private:
+        struct Column {
+            size_t start = 0;
+            std::vector<size_t> offsets;
+        };
+
+        std::string_view data;
+        size_t rowCount = 0;
+        uint16_t version = SCHEMA_VERSION;
+        std::vector<Column> columns;
+
+        void indexColumns(Reader& in) {
+            storedFields<T>(version, [&](const char*, auto member) {
+                using F = typename MemberType<decltype(member)>::type;
+                Column column;
+                column.start = in.tell();
+                if constexpr (FixedWidth<F>::value > 0) {
+                    in.skip(FixedWidth<F>::value * rowCount);
+                }
+                else if constexpr (std::is_same<F, std::string>::value) {
+                    column.offsets.reserve(rowCount);
+                    for (size_t row = 0; row < rowCount; ++row) {
+                        column.offsets.push_back(in.tell());
+                        in.skip(in.getUInt32());
+                    }
+                }
+                else {
+                    column.offsets.reserve(rowCount);
+                    for (size_t row = 0; row < rowCount; ++row) {
+                        column.offsets.push_back(in.tell());
+                        skipColumns<typename ListElement<F>::type>(in, in.getCount());
+                    }
+                }
+                columns.push_back(std::move(column));
+            });
+        }
+
+        template <typename F>
+        size_t columnOf(F T::* field) const {
+            size_t index = 0;
+            size_t found = columns.size();
+            Schema<T>::fields([&](const char*, auto member) {
+                if constexpr (std::is_same<decltype(member), F T::*>::value) {
+                    if (member == field) {
+                        found = index;
+                    }
+                }
+                ++index;
+            });
+            if (found >= columns.size()) {
+                throw std::invalid_argument(std::string("Field is not stored in ") + Schema<T>::name() + " snapshots.");
+            }
+            return found;
+        }
+    };
+}
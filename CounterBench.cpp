@@ -0,0 +1,179 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SongCounters.h"
+
+// Measures how SongCounters updates scale with the number of writer threads.
+//   CounterBench [--updates N] [--threads MAX]
+//
+// Each round runs 1, 2, 4 ... MAX writers, every one doing N updates, while
+// one reader keeps taking snapshots and checks that each song's weight
+// matches its vote count. Three layouts are timed:
+//   own song      every writer bumps its own padded counter
+//   shared song   all writers bump one counter
+//   one mutex     plain totals behind a single lock, as under the store lock
+
+static const int WEIGHT_PER_VOTE = 3;
+static const std::string EVENT_ID = "EV001";
+
+struct Result {
+    double seconds = 0;
+    long long snapshots = 0;
+    long long torn = 0;
+};
+
+// read() takes one snapshot and returns how many of its songs were torn, or
+// -1 when no snapshot could be taken.
+template <typename Update, typename Read>
+Result runWriters(size_t writers, long long updates, Update update, Read read) {
+    std::atomic<bool> started{ false };
+    std::atomic<size_t> finished{ 0 };
+    Result result;
+
+    std::thread reader([&] {
+        while (!started) {
+            std::this_thread::yield();
+        }
+        while (finished < writers) {
+            long long torn = read();
+            if (torn >= 0) {
+                result.snapshots++;
+                result.torn += torn;
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    auto begin = std::chrono::steady_clock::now();
+    started = true;
+    for (size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            for (long long i = 0; i < updates; ++i) {
+                update(w);
+            }
+            finished++;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    reader.join();
+    return result;
+}
+
+void printRow(const std::string& layout, size_t writers, long long updates, const Result& result, double baseline) {
+    double rate = writers * updates / result.seconds / 1e6;
+    std::cout << std::left << std::setw(14) << layout << std::right
+        << std::setw(8) << writers
+        << std::setw(14) << std::fixed << std::setprecision(1) << rate
+        << std::setw(10) << std::setprecision(2) << rate / baseline
+        << std::setw(12) << result.snapshots
+        << std::setw(8) << result.torn << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    long long updates = 2000000;
+    size_t maxThreads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--updates" && i + 1 < argc) {
+            updates = std::atoll(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            maxThreads = static_cast<size_t>(std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "Usage: CounterBench [--updates N] [--threads MAX]\n";
+            return 1;
+        }
+    }
+    if (maxThreads == 0) {
+        maxThreads = 1;
+    }
+    std::vector<size_t> writerCounts;
+    for (size_t writers = 1; writers < maxThreads; writers *= 2) {
+        writerCounts.push_back(writers);
+    }
+    writerCounts.push_back(maxThreads);
+
+    std::cout << std::left << std::setw(14) << "layout" << std::right << std::setw(8) << "threads"
+        << std::setw(14) << "Mupdates/s" << std::setw(10) << "speedup"
+        << std::setw(12) << "snapshots" << std::setw(8) << "torn" << "\n";
+
+    auto snapshotOf = [](const SongCounters& counters) {
+        return [&counters] {
+            std::vector<SongCounters::Count> counts;
+            if (!counters.snapshot(EVENT_ID, counts)) {
+                return -1LL;
+            }
+            long long torn = 0;
+            for (const auto& count : counts) {
+                if (count.weight != count.votes * WEIGHT_PER_VOTE) {
+                    torn++;
+                }
+            }
+            return torn;
+        };
+    };
+
+    long long torn = 0;
+    double baseline = 0;
+    for (size_t writers : writerCounts) {
+        SongCounters counters;
+        std::vector<size_t> slots;
+        for (size_t w = 0; w < writers; ++w) {
+            slots.push_back(counters.slot(EVENT_ID, "SNG" + std::to_string(w)));
+        }
+        counters.publish();
+        Result result = runWriters(writers, updates,
+            [&](size_t w) { counters.add(slots[w], 1, WEIGHT_PER_VOTE); }, snapshotOf(counters));
+        if (writers == 1) {
+            baseline = writers * updates / result.seconds / 1e6;
+        }
+        printRow("own song", writers, updates, result, baseline);
+        torn += result.torn;
+    }
+    for (size_t writers : writerCounts) {
+        SongCounters counters;
+        size_t slot = counters.slot(EVENT_ID, "SNG0");
+        counters.publish();
+        Result result = runWriters(writers, updates,
+            [&](size_t) { counters.add(slot, 1, WEIGHT_PER_VOTE); }, snapshotOf(counters));
+        printRow("shared song", writers, updates, result, baseline);
+        torn += result.torn;
+    }
+    for (size_t writers : writerCounts) {
+        std::mutex lock;
+        std::vector<long long> totals(writers * 2);
+        Result result = runWriters(writers, updates,
+            [&](size_t w) {
+                std::lock_guard<std::mutex> guard(lock);
+                totals[w * 2]++;
+                totals[w * 2 + 1] += WEIGHT_PER_VOTE;
+            },
+            [&] {
+                std::lock_guard<std::mutex> guard(lock);
+                long long mismatched = 0;
+                for (size_t w = 0; w < writers; ++w) {
+                    if (totals[w * 2 + 1] != totals[w * 2] * WEIGHT_PER_VOTE) {
+                        mismatched++;
+                    }
+                }
+                return mismatched;
+            });
+        printRow("one mutex", writers, updates, result, baseline);
+    }
+
+    if (torn > 0) {
+        std::cerr << torn << " snapshots mixed a vote count with another weight.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -2,237 +2,844 @@
 #include <unordered_set>
 #include "EventRegistration.h"
 #include <iostream>
+#include <cstdio>
+#include <memory>
 
 std::string DataManager::generateNewEventId() {
-	std::vector<Event> events = getAllActiveEvents();
+	return generateNewIds<Event>(eventFileName, "EV", 1).front();
+}
+
+std::string DataManager::generateNewAttendanceId() {
+	return generateNewAttendanceIds(1).front();
+}
+
+std::vector<std::string> DataManager::generateNewAttendanceIds(size_t count) {
+	return generateNewIds<Attendance>(attendanceFileName, "ATD", count);
+}
+
+std::string DataManager::generateNewVoteId() {
+	return generateNewVoteIds(1).front();
+}
+
+std::vector<std::string> DataManager::generateNewVoteIds(size_t count) {
+	return generateNewIds<Vote>(voteFileName, "VOTE", count);
+}
+
+std::string DataManager::generateNewRegistrationId() {
+	return generateNewRegistrationIds(1).front();
+}
+
+std::vector<std::string> DataManager::generateNewRegistrationIds(size_t count) {
+	return generateNewIds<Registration>(registrationFileName, "REG", count);
+}
 
-	if (events.empty()) {
-		return "EV001";
+std::string DataManager::generateNewRefundId() {
+	return generateNewIds<Refund>(refundFileName, "REF", 1).front();
+}
+
+// Payments can be created from several checkouts at once, so their ids come
+// from SnowflakeId rather than the on-disk counters.
+std::string DataManager::generateNewPaymentId() {
+	return SnowflakeId::next("PAY");
+}
+
+std::string DataManager::generateNewPerformanceId() {
+	return generateNewIds<Performance>(performanceFileName, "PERF", 1).front();
+}
+
+// Song ids used to come from global_song_counter.txt, which seeds the counter.
+std::string DataManager::generateNewSongId() {
+	long long number = IdAllocator::next("SONG", [] {
+		long long highest = 0;
+		std::ifstream file("global_song_counter.txt");
+		file >> highest;
+		return highest;
+	});
+	return IdAllocator::format("SONG", number, 4);
+}
+
+std::string DataManager::generateNewUserId(UserType userType) {
+	std::string prefix;
+	if (userType == UserType::ORGANIZER) {
+		prefix = "ORG";
+	}
+	else if (userType == UserType::CUSTOMER) {
+		prefix = "CUS";
+	}
+	else {
+		return "";
 	}
+	return generateNewIds<User>(userFileName, prefix, 1).front();
+}
 
-	std::string lastId = events.back().eventId;
-	int nextIdNum = std::stoi(lastId.substr(2)) + 1;
+int DataManager::getAvailableSeats(const std::string& eventId) {
+	const SeatMap& seatMap = getSeatMapForEvent(eventId);
+	return seatMap.capacity() - seatMap.occupiedCount();
+}
 
-	std::ostringstream oss;
-	oss << "EV" << std::setfill('0') << std::setw(3) << nextIdNum;
-	return oss.str();
+Event DataManager::getEventFromEventId(const std::string& targetEventId) {
+	const Event* event = residentTable<Event>(eventFileName).find(targetEventId);
+	return event ? *event : Event();
 }
 
-std::string DataManager::generateNewAttendanceId() {
-	std::vector<Attendance> attendances = getAllActiveAttendances();
+std::vector<Seat> DataManager::getOccupiedSeatsForEvent(const std::string& eventId) {
+	std::vector<Seat> occupiedSeats;
 
-	if (attendances.empty()) {
-		return "ATD001";
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, eventId)) {
+		if (reg->registrationStatus == RegistrationStatus::CANCELLED) {
+			continue;
+		}
+		for (const auto& seat : reg->seats) {
+			if (seat.status == SeatStatus::RESERVED) {
+				occupiedSeats.push_back(seat);
+			}
+		}
 	}
 
-	std::string lastId = attendances.back().attendanceId;
-	int nextIdNum = std::stoi(lastId.substr(3)) + 1;
+	return occupiedSeats;
+}
 
-	std::ostringstream oss;
-	oss << "ATD" << std::setfill('0') << std::setw(3) << nextIdNum;
-	return oss.str();
+std::unordered_map<std::string, SeatMap>& DataManager::seatMaps() {
+	static std::unordered_map<std::string, SeatMap> maps;
+	return maps;
 }
 
-std::string DataManager::generateNewVoteId() {
-	std::vector<Vote> votes = getAllActiveVotes();
-	if (votes.empty()) {
-		return "VOTE001";
+static bool holdsSeats(const Registration& reg) {
+	return !reg.isDeleted && reg.registrationStatus != RegistrationStatus::CANCELLED;
+}
+
+const SeatMap& DataManager::getSeatMapForEvent(const std::string& eventId) {
+	VenueLayout layout(getEventFromEventId(eventId));
+	auto it = seatMaps().find(eventId);
+	if (it != seatMaps().end() && it->second.layout() == layout) {
+		return it->second;
 	}
 
-	std::string lastId = votes.back().voteId;
-	int nextIdNum = std::stoi(lastId.substr(4)) + 1;
+	SeatMap map(layout);
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, eventId)) {
+		if (!holdsSeats(*reg)) {
+			continue;
+		}
+		for (const auto& seat : reg->seats) {
+			if (seat.status == SeatStatus::RESERVED) {
+				map.occupy(seat.row, seat.column);
+			}
+		}
+	}
+	return seatMaps()[eventId] = std::move(map);
+}
 
-	std::ostringstream oss;
-	oss << "VOTE" << std::setfill('0') << std::setw(3) << nextIdNum;
-	return oss.str();
+bool DataManager::isSeatOccupied(const std::string& eventId, const std::string& row, const std::string& column) {
+	return getSeatMapForEvent(eventId).isOccupied(row, column);
 }
 
-std::string DataManager::generateNewRegistrationId() {
-	std::vector<Registration> registrations = getAllActiveRegistrations();
+// Releases the seats the registration held before the write and occupies the
+// ones it holds after it. Maps not built yet are left for getSeatMapForEvent.
+void DataManager::updateDerivedIndexes(const Registration* before, const Registration& after) {
+	if (voteQuotas().isLoaded()) {
+		voteQuotas().setAllowed(after.registrationId, after.isDeleted ? 0 : static_cast<int>(after.seats.size()));
+	}
+
+	if (voteTally().isLoaded()) {
+		bool wasCounted = before && !before->isDeleted && !isRegistrationRefunded(before->registrationId);
+		bool nowCounted = !after.isDeleted && !isRegistrationRefunded(after.registrationId);
+		bool moved = before && before->eventId != after.eventId;
+		if (wasCounted && (!nowCounted || moved)) {
+			tallyVotesOf(before->registrationId, before->eventId, false);
+		}
+		if (nowCounted && (!wasCounted || moved)) {
+			tallyVotesOf(after.registrationId, after.eventId, true);
+		}
+	}
+
+	SeatHoldQueue& holds = seatHolds();
+	bool newHold = !before || before->registrationStatus != RegistrationStatus::PENDING || before->registerTime != after.registerTime;
+	if (holds.isLoaded() && after.registrationStatus == RegistrationStatus::PENDING && newHold) {
+		holds.add(after.registrationId, after.registerTime);
+	}
 
-	if (registrations.empty()) {
-		return "REG001";
+	auto& maps = seatMaps();
+	if (before && holdsSeats(*before)) {
+		auto it = maps.find(before->eventId);
+		if (it != maps.end()) {
+			for (const auto& seat : before->seats) {
+				if (seat.status == SeatStatus::RESERVED) {
+					it->second.release(seat.row, seat.column);
+				}
+			}
+		}
+	}
+	if (holdsSeats(after)) {
+		auto it = maps.find(after.eventId);
+		if (it != maps.end()) {
+			for (const auto& seat : after.seats) {
+				if (seat.status == SeatStatus::RESERVED) {
+					it->second.occupy(seat.row, seat.column);
+				}
+			}
+		}
 	}
+}
 
-	std::string lastId = registrations.back().registrationId;
-	int nextIdNum = std::stoi(lastId.substr(3)) + 1;
+void DataManager::resetDerivedIndexes(const std::vector<Registration>&) {
+	seatMaps().clear();
+	seatHolds().clear();
+	voteTally().clear();
+	voteQuotas().clear();
+	trendingSongs().clear();
+	audienceCounts().clear();
+}
 
-	std::ostringstream oss;
-	oss << "REG" << std::setfill('0') << std::setw(3) << nextIdNum;
-	return oss.str();
+VoteTally& DataManager::voteTally() {
+	static VoteTally tally;
+	return tally;
 }
 
-std::string DataManager::generateNewRefundId() {
-	std::vector<Refund> allRefund = getAllActiveRefunds();
+const VoteTally& DataManager::getVoteTally() {
+	// Load the tables first: loading runs the hooks below, which must not
+	// see a half-built tally.
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
+	residentTable<Vote>(voteFileName);
+	residentTable<Payment>(paymentFileName);
+
+	VoteTally& tally = voteTally();
+	if (!tally.isLoaded()) {
+		tally.clear();
+		for (const Registration& reg : registrations.all()) {
+			if (votesAreCounted(reg.registrationId)) {
+				tallyVotesOf(reg.registrationId, reg.eventId, true);
+			}
+		}
+		tally.markLoaded();
+	}
+	return tally;
+}
+
+const SongCounters& DataManager::getVoteCounters() {
+	return voteTally().counters();
+}
 
-	if (allRefund.empty()) {
-		return "REF001";
+// The payment being saved, when given, stands in for its stored version.
+bool DataManager::isRegistrationRefunded(const std::string& registrationId, const Payment* replacing) {
+	if (replacing && replacing->paymentStatus == PaymentStatus::REFUNDED && !replacing->isDeleted) {
+		return true;
 	}
+	for (const Payment* payment : residentTable<Payment>(paymentFileName).findBy(EntityKeys<Payment>::BY_REGISTRATION, registrationId)) {
+		if (replacing && payment->paymentId == replacing->paymentId) {
+			continue;
+		}
+		if (payment->paymentStatus == PaymentStatus::REFUNDED && !payment->isDeleted) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	std::string lastId = allRefund.back().refundId;
-	int nextIdNum = std::stoi(lastId.substr(3)) + 1;
+bool DataManager::votesAreCounted(const std::string& registrationId) {
+	const Registration* reg = residentTable<Registration>(registrationFileName).find(registrationId);
+	return reg && !reg->isDeleted && !isRegistrationRefunded(registrationId);
+}
 
-	std::ostringstream oss;
-	oss << "REF" << std::setfill('0') << std::setw(3) << nextIdNum;
-	return oss.str();
+void DataManager::tallyVotesOf(const std::string& registrationId, const std::string& eventId, bool add) {
+	VoteTally& tally = voteTally();
+	for (const Vote* vote : residentTable<Vote>(voteFileName).findBy(EntityKeys<Vote>::BY_REGISTRATION, registrationId)) {
+		if (vote->isDeleted) {
+			continue;
+		}
+		if (add) {
+			tally.add(eventId, vote->songId, vote->voteWeight);
+		}
+		else {
+			tally.remove(eventId, vote->songId, vote->voteWeight);
+		}
+	}
 }
 
-int DataManager::getAvailableSeats(const std::string& eventId) {
-	int totalSeats = getEventFromEventId(eventId).totalSeats;
+// The hooks run before the table takes the new record, so lookups still see
+// the stored version of it.
+void DataManager::updateDerivedIndexes(const Vote* before, const Vote& after) {
+	VoteQuota& quotas = voteQuotas();
+	if (quotas.isLoaded()) {
+		if (before && !before->isDeleted) {
+			quotas.addUsed(before->registrationId, -1);
+		}
+		if (!after.isDeleted) {
+			quotas.addUsed(after.registrationId, 1);
+		}
+	}
 
-	std::vector<Registration> registrations = getAllActiveRegistrations();
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
+	const Registration* voter = registrations.find(after.registrationId);
+	TrendingSongs& trends = trendingSongs();
+	if (trends.isLoaded() && !before && !after.isDeleted && voter) {
+		trends.add(voter->eventId, after.songId, after.voteWeight, after.voteTime);
+	}
+	AudienceCounts& audience = audienceCounts();
+	if (audience.isLoaded() && !after.isDeleted && voter) {
+		audience.addVoter(voter->eventId, voter->customerId);
+	}
 
-	int reservedSeats = 0;
-	for (const auto& reg : registrations) {
-		if (reg.eventId == eventId && reg.registrationStatus != RegistrationStatus::CANCELLED) {
-			reservedSeats += reg.seats.size();
+	VoteTally& tally = voteTally();
+	if (!tally.isLoaded()) {
+		return;
+	}
+	if (before && !before->isDeleted && votesAreCounted(before->registrationId)) {
+		tally.remove(registrations.find(before->registrationId)->eventId, before->songId, before->voteWeight);
+	}
+	if (!after.isDeleted && votesAreCounted(after.registrationId)) {
+		tally.add(registrations.find(after.registrationId)->eventId, after.songId, after.voteWeight);
+	}
+}
+
+void DataManager::resetDerivedIndexes(const std::vector<Vote>&) {
+	voteTally().clear();
+	voteQuotas().clear();
+	trendingSongs().clear();
+	audienceCounts().clear();
+}
+
+TrendingSongs& DataManager::trendingSongs() {
+	static TrendingSongs trends;
+	return trends;
+}
+
+AudienceCounts& DataManager::audienceCounts() {
+	static AudienceCounts audience;
+	return audience;
+}
+
+const AudienceCounts& DataManager::getAudienceCounts() {
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
+	const EntityTable<Vote>& votes = residentTable<Vote>(voteFileName);
+	const EntityTable<Attendance>& attendances = residentTable<Attendance>(attendanceFileName);
+
+	AudienceCounts& audience = audienceCounts();
+	if (!audience.isLoaded()) {
+		audience.clear();
+		for (const Vote& vote : votes.all()) {
+			const Registration* reg = registrations.find(vote.registrationId);
+			if (reg && !vote.isDeleted) {
+				audience.addVoter(reg->eventId, reg->customerId);
+			}
 		}
+		for (const Attendance& att : attendances.all()) {
+			const Registration* reg = registrations.find(att.registrationId);
+			if (reg && !att.isDeleted && att.attendanceStatus == AttendanceStatus::PRESENT) {
+				audience.addAttendee(reg->eventId, reg->customerId);
+			}
+		}
+		audience.markLoaded();
 	}
+	return audience;
+}
 
-	return totalSeats - reservedSeats;
+void DataManager::updateDerivedIndexes(const Attendance*, const Attendance& after) {
+	AudienceCounts& audience = audienceCounts();
+	if (!audience.isLoaded() || after.isDeleted || after.attendanceStatus != AttendanceStatus::PRESENT) {
+		return;
+	}
+	const Registration* reg = residentTable<Registration>(registrationFileName).find(after.registrationId);
+	if (reg) {
+		audience.addAttendee(reg->eventId, reg->customerId);
+	}
 }
 
-Event DataManager::getEventFromEventId(const std::string& targetEventId) {
-	std::vector<Event> events = getAllActiveEvents();
+void DataManager::resetDerivedIndexes(const std::vector<Attendance>&) {
+	audienceCounts().clear();
+}
 
-	for (auto a : events) {
-		if (a.eventId == targetEventId) {
-			return a;
+const TrendingSongs& DataManager::getTrendingSongs() {
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
+	const EntityTable<Vote>& votes = residentTable<Vote>(voteFileName);
+
+	TrendingSongs& trends = trendingSongs();
+	if (!trends.isLoaded()) {
+		trends.clear();
+		for (const Vote& vote : votes.all()) {
+			const Registration* reg = registrations.find(vote.registrationId);
+			if (reg && !vote.isDeleted) {
+				trends.add(reg->eventId, vote.songId, vote.voteWeight, vote.voteTime);
+			}
 		}
+		trends.markLoaded();
 	}
-	return Event();
+	return trends;
 }
 
-std::vector<Seat> DataManager::getOccupiedSeatsForEvent(const std::string& eventId) {
-	std::vector<Seat> occupiedSeats;
+VoteQuota& DataManager::voteQuotas() {
+	static VoteQuota quotas;
+	return quotas;
+}
 
-	for (Registration& reg : getAllActiveRegistrations()) {
-		if (reg.registrationStatus == RegistrationStatus::CANCELLED) {
+VoteQuota::Entry DataManager::getVoteQuota(const std::string& registrationId) {
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
+	const EntityTable<Vote>& votes = residentTable<Vote>(voteFileName);
+
+	VoteQuota& quotas = voteQuotas();
+	if (!quotas.isLoaded()) {
+		quotas.clear();
+		for (const Registration& reg : registrations.all()) {
+			quotas.setAllowed(reg.registrationId, reg.isDeleted ? 0 : static_cast<int>(reg.seats.size()));
+		}
+		for (const Vote& vote : votes.all()) {
+			if (!vote.isDeleted) {
+				quotas.addUsed(vote.registrationId, 1);
+			}
+		}
+		quotas.markLoaded();
+	}
+	return quotas.entry(registrationId);
+}
+
+bool DataManager::castVote(Vote& vote, std::string& error) {
+	std::vector<Vote> votes{ vote };
+	std::vector<std::string> errors;
+	if (castVotes(votes, errors) == 0) {
+		error = errors.front();
+		return false;
+	}
+	vote = votes.front();
+	return true;
+}
+
+size_t DataManager::castVotes(std::vector<Vote>& votes, std::vector<std::string>& errors) {
+	errors.assign(votes.size(), "");
+	if (votes.empty()) {
+		return 0;
+	}
+
+	std::lock_guard<StoreMutex> guard(storeMutex());
+	// Registrations are brought up to date first, so no other entity's lock
+	// is taken while the vote lock is held.
+	refreshFromDisk<Registration>(registrationFileName);
+	EntityLock lock(voteFileName);
+	refreshFromDisk<Vote>(voteFileName);
+
+	// Earlier ballots of the batch count against the same registration.
+	std::unordered_map<std::string, int> remaining;
+	std::vector<size_t> accepted;
+	size_t idsNeeded = 0;
+	for (size_t i = 0; i < votes.size(); ++i) {
+		const std::string& registrationId = votes[i].registrationId;
+		auto it = remaining.find(registrationId);
+		if (it == remaining.end()) {
+			it = remaining.emplace(registrationId, getVoteQuota(registrationId).remaining()).first;
+		}
+		if (it->second <= 0) {
+			errors[i] = "Registration " + registrationId + " has no votes left.";
 			continue;
 		}
-		if (reg.eventId == eventId) {
-			for (const auto& seat : reg.seats) {
-				if (seat.status == SeatStatus::RESERVED) {
-					occupiedSeats.push_back(seat);
+		--it->second;
+		accepted.push_back(i);
+		if (votes[i].voteId.empty()) {
+			++idsNeeded;
+		}
+	}
+	if (accepted.empty()) {
+		return 0;
+	}
+
+	std::vector<std::string> ids = idsNeeded > 0 ? generateNewVoteIds(idsNeeded) : std::vector<std::string>();
+	size_t nextId = 0;
+	std::vector<Vote> records;
+	records.reserve(accepted.size());
+	for (size_t i : accepted) {
+		if (votes[i].voteId.empty()) {
+			votes[i].voteId = ids[nextId++];
+		}
+		records.push_back(votes[i]);
+	}
+	saveRecords(records, voteFileName);
+	return accepted.size();
+}
+
+void DataManager::updateDerivedIndexes(const Payment*, const Payment& after) {
+	if (!voteTally().isLoaded()) {
+		return;
+	}
+	const Registration* reg = residentTable<Registration>(registrationFileName).find(after.registrationId);
+	if (!reg || reg->isDeleted) {
+		return;
+	}
+	bool wasRefunded = isRegistrationRefunded(after.registrationId);
+	bool nowRefunded = isRegistrationRefunded(after.registrationId, &after);
+	if (wasRefunded != nowRefunded) {
+		tallyVotesOf(reg->registrationId, reg->eventId, wasRefunded);
+	}
+}
+
+void DataManager::resetDerivedIndexes(const std::vector<Payment>&) {
+	voteTally().clear();
+}
+
+DataManager::StoreMutex& DataManager::storeMutex() {
+	static StoreMutex mutex;
+	return mutex;
+}
+
+void DataManager::StoreMutex::lock() {
+	std::unique_lock<std::mutex> guard(mutex);
+	std::thread::id self = std::this_thread::get_id();
+	if (owner == self) {
+		depth++;
+		return;
+	}
+	released.wait(guard, [this] { return depth == 0; });
+	owner = self;
+	depth = 1;
+}
+
+void DataManager::StoreMutex::unlock() {
+	std::lock_guard<std::mutex> guard(mutex);
+	if (--depth == 0) {
+		owner = std::thread::id();
+		released.notify_one();
+	}
+}
+
+int DataManager::StoreMutex::releaseAll() {
+	std::lock_guard<std::mutex> guard(mutex);
+	if (owner != std::this_thread::get_id()) {
+		return 0;
+	}
+	int levels = depth;
+	depth = 0;
+	owner = std::thread::id();
+	released.notify_one();
+	return levels;
+}
+
+void DataManager::StoreMutex::reacquire(int levels) {
+	if (levels == 0) {
+		return;
+	}
+	std::unique_lock<std::mutex> guard(mutex);
+	released.wait(guard, [this] { return depth == 0; });
+	owner = std::this_thread::get_id();
+	depth = levels;
+}
+
+void DataManager::loadAllTables() {
+	residentTable<User>(userFileName);
+	residentTable<Event>(eventFileName);
+	residentTable<Registration>(registrationFileName);
+	residentTable<Payment>(paymentFileName);
+	residentTable<Refund>(refundFileName);
+	residentTable<Performance>(performanceFileName);
+	residentTable<Vote>(voteFileName);
+	residentTable<Attendance>(attendanceFileName);
+}
+
+struct DataManager::EntityLock::Holder {
+	std::recursive_mutex mutex;
+	FileManagement::FileLock file;
+	int depth = 0;
+};
+
+DataManager::EntityLock::Holder& DataManager::EntityLock::holderOf(const std::string& filename) {
+	static std::mutex holdersMutex;
+	static std::unordered_map<std::string, std::unique_ptr<Holder>> holders;
+	std::lock_guard<std::mutex> guard(holdersMutex);
+	std::unique_ptr<Holder>& holder = holders[filename];
+	if (!holder) {
+		holder.reset(new Holder());
+	}
+	return *holder;
+}
+
+DataManager::EntityLock::EntityLock(const std::string& filename) : holder(holderOf(filename)) {
+	// The store lock is taken back once this lock is held, never the other
+	// way round, so two threads can never wait on each other.
+	StoreRelease unlocked;
+	holder.mutex.lock();
+	if (holder.depth == 0 && !holder.file.lock(filename + ".lock")) {
+		holder.mutex.unlock();
+		throw std::runtime_error("Unable to lock data file " + filename + ".");
+	}
+	holder.depth++;
+}
+
+DataManager::EntityLock::~EntityLock() {
+	if (--holder.depth == 0) {
+		holder.file.unlock();
+	}
+	holder.mutex.unlock();
+}
+
+// Seats of the registration that are outside the venue or held by another
+// registration. Seats the registration already holds do not conflict.
+bool DataManager::findSeatConflicts(const Registration& registration, std::vector<std::string>& takenSeats) {
+	takenSeats.clear();
+	if (!holdsSeats(registration)) {
+		return false;
+	}
+
+	const SeatMap& seatMap = getSeatMapForEvent(registration.eventId);
+	const Registration* current = residentTable<Registration>(registrationFileName).find(registration.registrationId);
+	for (const Seat& seat : registration.seats) {
+		if (seat.status != SeatStatus::RESERVED) {
+			continue;
+		}
+		bool alreadyHeld = current && holdsSeats(*current) && current->eventId == registration.eventId
+			&& std::any_of(current->seats.begin(), current->seats.end(), [&](const Seat& held) {
+				return held.status == SeatStatus::RESERVED && held.row == seat.row && held.column == seat.column;
+			});
+		if (!seatMap.contains(VenueLayout::parseNumber(seat.row), VenueLayout::parseNumber(seat.column))
+			|| (seatMap.isOccupied(seat.row, seat.column) && !alreadyHeld)) {
+			takenSeats.push_back(seat.seatId);
+		}
+	}
+	return !takenSeats.empty();
+}
+
+// The plan is first made against the registrations as last read, without
+// the lock, and only redone under it when other writers, in this process or
+// another, changed them since.
+bool DataManager::commitSeatPlan(const std::function<bool(std::vector<Registration>&)>& plan) {
+	const EntityTable<Registration>& table = EntityStore::table<Registration>(registrationFileName);
+	size_t revision = table.revision();
+	std::vector<Registration> records;
+	bool planned = plan(records);
+
+	EntityLock lock(registrationFileName);
+	refreshFromDisk<Registration>(registrationFileName);
+	if (table.revision() != revision) {
+		records.clear();
+		planned = plan(records);
+	}
+	if (!planned) {
+		return false;
+	}
+	saveRecords(records, registrationFileName);
+	return true;
+}
+
+bool DataManager::reserveSeats(const Registration& registration, std::vector<std::string>& takenSeats) {
+	return commitSeatPlan([&](std::vector<Registration>& records) {
+		if (findSeatConflicts(registration, takenSeats)) {
+			return false;
+		}
+		records.push_back(registration);
+		return true;
+	});
+}
+
+// Splits a seat id such as "R12C7" into its row and column.
+static bool parseSeatId(const std::string& seatId, int& row, int& column) {
+	size_t r = seatId.find('R');
+	size_t c = seatId.find('C');
+	if (r != 0 || c == std::string::npos || c < 2) {
+		return false;
+	}
+	row = VenueLayout::parseNumber(seatId.substr(1, c - 1));
+	column = VenueLayout::parseNumber(seatId.substr(c + 1));
+	return row > 0 && column > 0;
+}
+
+bool DataManager::bookGroup(const std::vector<BookingRequest>& requests, time_t registerTime,
+	std::vector<Registration>& booked, std::string& error) {
+	booked.clear();
+	error.clear();
+	if (requests.empty()) {
+		return true;
+	}
+	std::vector<std::string> registrationIds = generateNewRegistrationIds(requests.size());
+	const EntityTable<User>& users = residentTable<User>(userFileName);
+
+	bool committed = commitSeatPlan([&](std::vector<Registration>& records) {
+		// Seats claimed earlier in the batch are marked on per-event copies.
+		std::unordered_map<std::string, SeatMap> working;
+
+		for (size_t i = 0; i < requests.size(); ++i) {
+			const BookingRequest& request = requests[i];
+			std::string label = "Request " + std::to_string(i + 1) + ": ";
+
+			const Event* event = residentTable<Event>(eventFileName).find(request.eventId);
+			// Same rule as EventBooking: only scheduled events that have not started yet.
+			if (!event || event->isDeleted || event->status != EventStatus::SCHEDULED || registerTime >= event->startTime) {
+				error = label + "event " + request.eventId + " is not open for booking.";
+				return false;
+			}
+			const User* customer = users.find(request.customerId);
+			if (!customer || customer->isDeleted) {
+				error = label + "customer " + request.customerId + " does not exist.";
+				return false;
+			}
+
+			auto it = working.find(request.eventId);
+			if (it == working.end()) {
+				it = working.emplace(request.eventId, getSeatMapForEvent(request.eventId)).first;
+			}
+			SeatMap& seatMap = it->second;
+
+			std::vector<std::pair<int, int>> seats;
+			if (!request.seatIds.empty()) {
+				for (const std::string& seatId : request.seatIds) {
+					int row = 0;
+					int column = 0;
+					if (!parseSeatId(seatId, row, column) || !seatMap.contains(row, column) || seatMap.isOccupied(row, column)) {
+						error = label + "seat " + seatId + " of event " + request.eventId + " is not available.";
+						return false;
+					}
+					seatMap.occupy(row, column);
+					seats.emplace_back(row, column);
 				}
 			}
+			else {
+				seats = seatMap.bestAvailable(request.seatCount);
+				if (seats.empty()) {
+					error = label + "event " + request.eventId + " does not have " + std::to_string(request.seatCount) + " free seats.";
+					return false;
+				}
+				for (const auto& seat : seats) {
+					seatMap.occupy(seat.first, seat.second);
+				}
+			}
+
+			Registration reg;
+			reg.registrationId = registrationIds[i];
+			reg.customerId = request.customerId;
+			reg.eventId = request.eventId;
+			reg.registerTime = registerTime;
+			reg.registrationStatus = request.status;
+			for (const auto& seat : seats) {
+				Seat s;
+				s.row = std::to_string(seat.first);
+				s.column = std::to_string(seat.second);
+				s.seatId = "R" + s.row + "C" + s.column;
+				s.registrationId = reg.registrationId;
+				s.status = SeatStatus::RESERVED;
+				reg.seats.push_back(s);
+			}
+			records.push_back(reg);
 		}
-	}
+		booked = records;
+		return true;
+	});
 
-	return occupiedSeats;
+	if (!committed) {
+		booked.clear();
+	}
+	return committed;
 }
 
 std::vector<Registration> DataManager::getRegistrationsForEvent(const std::string& eventId) {
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
 	std::vector<Registration> eventRegistrations;
-	for (const Registration& reg : allRegistrations) {
-		if (reg.eventId == eventId && reg.registrationStatus != RegistrationStatus::CANCELLED) {
-			eventRegistrations.push_back(reg);
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, eventId)) {
+		if (reg->registrationStatus != RegistrationStatus::CANCELLED) {
+			eventRegistrations.push_back(*reg);
 		}
 	}
 	return eventRegistrations;
 }
 
-void DataManager::getAttendanceFromEvent(std::vector<std::vector<int>>& venueAttendance, Event& event) {
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
-	std::vector<Attendance> allAttendances = getAllActiveAttendances();
+std::vector<Registration> DataManager::getRegistrationsForCustomer(const std::string& customerId) {
+	std::vector<Registration> customerRegistrations;
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_CUSTOMER, customerId)) {
+		customerRegistrations.push_back(*reg);
+	}
+	return customerRegistrations;
+}
 
-	std::vector<Registration> eventRegistrations;
-	for (const Registration& reg : allRegistrations) {
-		if (reg.eventId == event.eventId &&
-			(reg.registrationStatus != RegistrationStatus::CANCELLED)) {
-			eventRegistrations.push_back(reg);
+std::vector<Payment> DataManager::getPaymentsForRegistration(const std::string& registrationId) {
+	std::vector<Payment> registrationPayments;
+	for (const Payment* payment : residentTable<Payment>(paymentFileName).findBy(EntityKeys<Payment>::BY_REGISTRATION, registrationId)) {
+		registrationPayments.push_back(*payment);
+	}
+	return registrationPayments;
+}
+
+std::vector<Payment> DataManager::getPaymentsForEvent(const std::string& eventId) {
+	const EntityTable<Payment>& payments = residentTable<Payment>(paymentFileName);
+	std::vector<Payment> eventPayments;
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, eventId)) {
+		for (const Payment* payment : payments.findBy(EntityKeys<Payment>::BY_REGISTRATION, reg->registrationId)) {
+			eventPayments.push_back(*payment);
 		}
 	}
+	return eventPayments;
+}
 
-	std::unordered_map<std::string, AttendanceStatus> attendanceMap;
-	for (const Attendance& att : allAttendances) {
-		attendanceMap[att.registrationId] = att.attendanceStatus;
+std::vector<Attendance> DataManager::getAttendancesForRegistration(const std::string& registrationId) {
+	std::vector<Attendance> registrationAttendances;
+	for (const Attendance* att : residentTable<Attendance>(attendanceFileName).findBy(EntityKeys<Attendance>::BY_REGISTRATION, registrationId)) {
+		registrationAttendances.push_back(*att);
 	}
+	return registrationAttendances;
+}
+
+void DataManager::getAttendanceFromEvent(std::vector<std::vector<int>>& venueAttendance, Event& event) {
+	const EntityTable<Attendance>& attendances = residentTable<Attendance>(attendanceFileName);
 
-	for (auto& row : venueAttendance) {
-		for (auto& seat : row) {
-			seat = -1;
+	std::vector<const Registration*> eventRegistrations;
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, event.eventId)) {
+		if (reg->registrationStatus != RegistrationStatus::CANCELLED) {
+			eventRegistrations.push_back(reg);
 		}
 	}
 
-	for (const Registration& reg : eventRegistrations) {
-		bool isPresent = false;
-		auto attendanceIt = attendanceMap.find(reg.registrationId);
+	VenueLayout layout(event);
+	venueAttendance.assign(layout.rowCount(), std::vector<int>());
+	for (int row = 1; row <= layout.rowCount(); ++row) {
+		venueAttendance[row - 1].assign(layout.seatsInRow(row), -1);
+	}
 
+	for (const Registration* reg : eventRegistrations) {
+		bool isPresent = false;
+		std::vector<const Attendance*> regAttendances = attendances.findBy(EntityKeys<Attendance>::BY_REGISTRATION, reg->registrationId);
 
-		if (attendanceIt != attendanceMap.end()) {
-			if (attendanceIt->second == AttendanceStatus::PRESENT) {
+		if (!regAttendances.empty()) {
+			if (regAttendances.back()->attendanceStatus == AttendanceStatus::PRESENT) {
 				isPresent = true;
 			}
 		}
 
-		for (const Seat& seat : reg.seats) {
-			int rowIndex = std::stoi(seat.row) - 1;
-			int columnIndex = std::stoi(seat.column) - 1;
+		for (const Seat& seat : reg->seats) {
+			int row = VenueLayout::parseNumber(seat.row);
+			int column = VenueLayout::parseNumber(seat.column);
 
-			if (rowIndex >= 0 && rowIndex < venueAttendance.size() &&
-				columnIndex >= 0 && columnIndex < venueAttendance[0].size()) {
-				venueAttendance[rowIndex][columnIndex] = isPresent ? 1 : 0;
+			if (layout.seatNumber(row, column) >= 0) {
+				venueAttendance[row - 1][column - 1] = isPresent ? 1 : 0;
 			}
 		}
 	}
 }
 
 Registration DataManager::getRegistrationFromRegistrationId(const std::string& registrationId) {
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
-	for (Registration reg : allRegistrations) {
-		if (reg.registrationId == registrationId) {
-			return reg;
-		}
-	}
-	return Registration();
+	const Registration* reg = residentTable<Registration>(registrationFileName).find(registrationId);
+	return reg ? *reg : Registration();
 }
 
 Registration DataManager::getRegistrationFromEventId(const std::string& eventId, const std::string& userId) {
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
-	std::vector<Registration> relevantRegistrations;
-
-	for (Registration reg : allRegistrations) {
-		if (reg.eventId == eventId && reg.customerId == userId) {
-			return reg;
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_CUSTOMER, userId)) {
+		if (reg->eventId == eventId) {
+			return *reg;
 		}
 	}
+	return Registration();
 }
 
 User DataManager::getUserFromUserId(const std::string& userId) {
-	std::vector<User> allUsers = getAllActiveUsers();
-
-	for (User user : allUsers) {
-		if (user.userId == userId) {
-			return user;
-		}
-	}
+	const User* user = residentTable<User>(userFileName).find(userId);
+	return user ? *user : User();
 }
 
 Payment DataManager::getPaymentFromPaymentId(const std::string& paymentId){
-	std::vector<Payment> allPayments = getAllActivePayments();
-
-	for (Payment payment : allPayments) {
-		if (payment.paymentId == paymentId) {
-			return payment;
-		}
-	}
+	const Payment* payment = residentTable<Payment>(paymentFileName).find(paymentId);
+	return payment ? *payment : Payment();
 }
 
 std::vector<User> DataManager::getAllActiveUsers() {
-	auto allUsers = loadData<User>(userFileName);
-	return allUsers;
+	return residentData<User>(userFileName);
 }
 	
 std::vector<Event> DataManager::getAllActiveEvents() {
-	auto allEvents = loadData<Event>(eventFileName);
-	return allEvents;
+	return residentData<Event>(eventFileName);
 }
 
 std::vector<Event> DataManager::getAllScheduledEvent() {
 	std::vector<Event> scheduledEvent;
-	for (Event event : getAllActiveEvents()) {
+	for (const Event& event : residentData<Event>(eventFileName)) {
 		if (event.status == EventStatus::SCHEDULED) {
 			scheduledEvent.push_back(event);
 		}
@@ -241,38 +848,33 @@ std::vector<Event> DataManager::getAllScheduledEvent() {
 }
 
 std::vector<Registration> DataManager::getAllActiveRegistrations() {
-	auto allRegistrations = loadData<Registration>(registrationFileName);
-	return allRegistrations;
+	return residentData<Registration>(registrationFileName);
 }
 
 std::vector<Payment> DataManager::getAllActivePayments() {
-	auto allPayments = loadData<Payment>(paymentFileName);
-	return allPayments;
+	return residentData<Payment>(paymentFileName);
 }
 
 std::vector<Refund> DataManager::getAllActiveRefunds() {
-	auto allRefunds = loadData<Refund>(refundFileName);
-	return allRefunds;
+	return residentData<Refund>(refundFileName);
 }
 
 std::vector<Performance> DataManager::getAllActivePerformances() {
-	auto allPerformances = loadData<Performance>(performanceFileName);
-	return allPerformances;
+	return residentData<Performance>(performanceFileName);
 }
 
 std::vector<Vote> DataManager::getAllActiveVotes() {
-	auto allVotes = loadData<Vote>(voteFileName);
-	return allVotes;
+	return residentData<Vote>(voteFileName);
 }
 
 std::vector<Attendance> DataManager::getAllActiveAttendances() {
-	auto allAttendances = loadData<Attendance>(attendanceFileName);
-	return allAttendances;
+	return residentData<Attendance>(attendanceFileName);
 }
 
 void DataManager::updateEventStatus(time_t& currentDateTime) {
-	std::vector<Event> allEvents = getAllActiveEvents();
-	for (Event& event : allEvents) {
+	std::vector<Event> changedEvents;
+	for (Event event : residentData<Event>(eventFileName)) {
+		EventStatus previousStatus = event.status;
 		if (event.status == EventStatus::CANCELLED) {
 			continue;
 		}
@@ -285,84 +887,93 @@ void DataManager::updateEventStatus(time_t& currentDateTime) {
 		else if (currentDateTime > event.endTime) {
 			event.status = EventStatus::COMPLETED;
 		}
+		if (event.status != previousStatus) {
+			changedEvents.push_back(event);
+		}
 	}
-	saveData(allEvents, eventFileName);
+	saveRecords(changedEvents, eventFileName);
 	updateAttendanceStatus();
-	updateRegistrationStatus(currentDateTime);
-}
-
-void DataManager::updateRegistrationStatus(time_t& currentDateTime) {
-	Validation validation;
-	bool changeMade = false;
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
-	for (Registration& reg : allRegistrations) {
-		if (reg.registrationStatus == RegistrationStatus::PENDING) {
-			if (!validation.validateUnpaidRegistration(reg.registerTime, currentDateTime)) {
-				changeMade = true;
-				reg.registrationStatus = RegistrationStatus::CANCELLED;
+	expireSeatHolds(currentDateTime);
+}
+
+SeatHoldQueue& DataManager::seatHolds() {
+	static SeatHoldQueue holds;
+	return holds;
+}
+
+size_t DataManager::expireSeatHolds(time_t currentDateTime) {
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
+	SeatHoldQueue& holds = seatHolds();
+	if (!holds.isLoaded()) {
+		for (const Registration& reg : registrations.all()) {
+			if (reg.registrationStatus == RegistrationStatus::PENDING) {
+				holds.add(reg.registrationId, reg.registerTime);
 			}
 		}
+		holds.markLoaded();
 	}
-	if (changeMade) {
-		saveData(allRegistrations, registrationFileName);
+
+	std::vector<Registration> expiredRegistrations;
+	for (const SeatHoldQueue::Hold& hold : holds.takeExpired(currentDateTime)) {
+		const Registration* reg = registrations.find(hold.registrationId);
+		// Skip holds that were paid, cancelled or renewed since they were queued.
+		if (reg && reg->registrationStatus == RegistrationStatus::PENDING
+			&& reg->registerTime + SeatHoldQueue::HOLD_TTL == hold.expiresAt) {
+			Registration expired = *reg;
+			expired.registrationStatus = RegistrationStatus::CANCELLED;
+			expiredRegistrations.push_back(expired);
+		}
 	}
+	saveRecords(expiredRegistrations, registrationFileName);
+	return expiredRegistrations.size();
 }
 
 void DataManager::updateAttendanceStatus() {
-	std::vector<Attendance> allAttendances = loadData<Attendance>(attendanceFileName);
-	std::vector<Event> allEvents = loadData<Event>(eventFileName);
-	std::vector<Registration> allRegistrations = loadData<Registration>(registrationFileName);
+	const EntityTable<Attendance>& attendances = residentTable<Attendance>(attendanceFileName);
+	const EntityTable<Registration>& registrations = residentTable<Registration>(registrationFileName);
 
-	bool changesMade = false;
+	std::vector<Attendance> newAttendances;
 
-	for (const Event& event : allEvents) {
+	for (const Event& event : residentData<Event>(eventFileName)) {
 		if (event.status == EventStatus::COMPLETED) {
-			std::vector<Registration> eventRegistrations;
-			for (const Registration& reg : allRegistrations) {
-				if (reg.eventId == event.eventId) {
-					eventRegistrations.push_back(reg);
-				}
-			}
-
-			for (const Registration& reg : eventRegistrations) {
-				bool attendanceExists = false;
-
-				for (const Attendance& attendance : allAttendances) {
-					if (attendance.registrationId == reg.registrationId) {
-						attendanceExists = true;
-						break;
-					}
-				}
+			for (const Registration* regPtr : registrations.findBy(EntityKeys<Registration>::BY_EVENT, event.eventId)) {
+				const Registration& reg = *regPtr;
+				bool attendanceExists = !attendances.findBy(EntityKeys<Attendance>::BY_REGISTRATION, reg.registrationId).empty();
 
 				if (!attendanceExists) {
 					Attendance att;
-					att.attendanceId = generateNewAttendanceId();
 					att.registrationId = reg.registrationId;
 					att.attendanceStatus = AttendanceStatus::ABSENT;
 					att.isDeleted = false;
 
-					allAttendances.push_back(att);
-					changesMade = true;
-
-					std::cout << "Created ABSENT attendance for registration: "
-						<< reg.registrationId << std::endl;
+					newAttendances.push_back(att);
 				}
 			}
 		}
 	}
 
-	if (changesMade) {
-		saveData(allAttendances, attendanceFileName);
+	if (newAttendances.empty()) {
+		return;
+	}
+
+	std::vector<std::string> ids = generateNewAttendanceIds(newAttendances.size());
+	for (size_t i = 0; i < newAttendances.size(); ++i) {
+		newAttendances[i].attendanceId = ids[i];
+	}
+	saveRecords(newAttendances, attendanceFileName);
+
+	for (const Attendance& att : newAttendances) {
+		std::cout << "Created ABSENT attendance for registration: "
+			<< att.registrationId << std::endl;
 	}
 }
 
 std::vector<std::vector<std::string>> DataManager::loadScheduledAndOngoingDataOfUser(const std::string& userId) {
 	std::vector<std::vector<std::string>> eventsData;
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
 	std::vector<Registration> relevantRegistrations;
 	std::unordered_map<std::string, Event> eventCache;
 
-	for (const Registration& reg : allRegistrations) {
+	for (const Registration& reg : residentData<Registration>(registrationFileName)) {
 		if (reg.registrationStatus == RegistrationStatus::CANCELLED) continue;
 		if (reg.customerId != userId) continue;
 
@@ -434,10 +1045,9 @@ std::vector<std::vector<std::string>> DataManager::loadScheduledAndOngoingDataOf
 
 std::vector<std::vector<std::string>> DataManager::loadScheduledAndOngoingDataOfOrganizer(std::string& userId) {
 	std::vector<std::vector<std::string>> eventsData;
-	std::vector<Event> allEvents = getAllActiveEvents();
 	std::vector<Event> relevantEvents;
 
-	for (Event& event : allEvents) {
+	for (const Event& event : residentData<Event>(eventFileName)) {
 		if(event.organizerId == userId || userId == "ADM001") {
 			relevantEvents.push_back(event);
 		}
@@ -499,16 +1109,15 @@ std::vector<std::vector<std::string>> DataManager::loadScheduledAndOngoingDataOf
 
 // { "No.", "Time", "Payment Id", "Amount", "Method", "Status", "Customer"
 void DataManager::loadCompletedSalesOfEvent(std::vector<std::vector<std::string>>& sales, double& totalSales, Event& event) {
-	std::vector<Payment> allPayments = getAllActivePayments();
+	std::unordered_map<std::string, const Registration*> eventRegistrations = mapRegistrationsOfEvent(event.eventId);
+	const EntityTable<User>& users = residentTable<User>(userFileName);
 
 	int paymentNumber = 1;
-	for(Payment& payment : allPayments){
+	for(const Payment& payment : residentData<Payment>(paymentFileName)){
 		std::vector<std::string> paymentRow;
 
-		if (getRegistrationFromRegistrationId(payment.registrationId).eventId != event.eventId) {
-			continue;
-		}
-		if (payment.paymentStatus != PaymentStatus::COMPLETED && getRegistrationFromRegistrationId(payment.registrationId).eventId != event.eventId) {
+		auto regIt = eventRegistrations.find(payment.registrationId);
+		if (regIt == eventRegistrations.end()) {
 			continue;
 		}
 
@@ -560,7 +1169,7 @@ void DataManager::loadCompletedSalesOfEvent(std::vector<std::vector<std::string>
 		paymentRow.push_back(paymentStatus);
 
 		// Customer Name
-		paymentRow.push_back(getUserFromUserId(getRegistrationFromRegistrationId(payment.registrationId).customerId).username);
+		paymentRow.push_back(usernameOf(users, regIt->second->customerId));
 
 		sales.push_back(paymentRow);
 		totalSales += payment.amount;
@@ -574,12 +1183,18 @@ void DataManager::loadCompletedSalesOfEvent(std::vector<std::vector<std::string>
 
 // {No. RefundId, PaymentId, Customer, Refund Amount, Reason, Status}
 void DataManager::loadRefundedSalesOfEvent(std::vector<std::vector<std::string>>& sales, Event& event) {
-	std::vector<Refund> allRefunds = getAllActiveRefunds();
+	std::unordered_map<std::string, const Registration*> eventRegistrations = mapRegistrationsOfEvent(event.eventId);
+	const EntityTable<Payment>& payments = residentTable<Payment>(paymentFileName);
+	const EntityTable<User>& users = residentTable<User>(userFileName);
 
 	int refundNumber = 1;
-	for(Refund refund : allRefunds){
-
-		if (getRegistrationFromRegistrationId(getPaymentFromPaymentId(refund.paymentId).registrationId).eventId != event.eventId) {
+	for(const Refund& refund : residentData<Refund>(refundFileName)){
+		const Payment* payment = payments.find(refund.paymentId);
+		if (!payment) {
+			continue;
+		}
+		auto regIt = eventRegistrations.find(payment->registrationId);
+		if (regIt == eventRegistrations.end()) {
 			continue;
 		}
 
@@ -598,7 +1213,7 @@ void DataManager::loadRefundedSalesOfEvent(std::vector<std::vector<std::string>>
 		refundRow.push_back(refund.paymentId);
 
 		// Customer Name
-		refundRow.push_back(getUserFromUserId(getRegistrationFromRegistrationId(getPaymentFromPaymentId(refund.paymentId).registrationId).customerId).username);
+		refundRow.push_back(usernameOf(users, regIt->second->customerId));
 
 		// Refund Amount
 		std::stringstream ss;
@@ -621,15 +1236,18 @@ void DataManager::loadRefundedSalesOfEvent(std::vector<std::vector<std::string>>
 
  //No. AttendanceId Customer Event Status Time Seat
 std::vector<std::vector<std::string>> DataManager::loadAttendanceMonitoring(Event& event) {
-	std::vector<Attendance> allAttendances = getAllActiveAttendances();
 	std::vector<std::vector<std::string>> attendanceData;
+	std::unordered_map<std::string, const Registration*> eventRegistrations = mapRegistrationsOfEvent(event.eventId);
+	const EntityTable<User>& users = residentTable<User>(userFileName);
 
 	int attendanceNumber = 1;
 	
-	for(Attendance att : allAttendances){
-		if(getRegistrationFromRegistrationId((att.registrationId)).eventId != event.eventId){
+	for(const Attendance& att : residentData<Attendance>(attendanceFileName)){
+		auto regIt = eventRegistrations.find(att.registrationId);
+		if(regIt == eventRegistrations.end()){
 			continue;
 		}
+		const Registration& registration = *regIt->second;
 		
 		std::vector<std::string> attendanceRow;
 		
@@ -640,10 +1258,10 @@ std::vector<std::vector<std::string>> DataManager::loadAttendanceMonitoring(Even
 		attendanceRow.push_back(att.attendanceId);
 
 		// Customer Name
-		attendanceRow.push_back(getUserFromUserId(getRegistrationFromRegistrationId(att.registrationId).customerId).username);
+		attendanceRow.push_back(usernameOf(users, registration.customerId));
 	
 		// Event Name
-		attendanceRow.push_back(getEventFromEventId(getRegistrationFromRegistrationId(att.registrationId).eventId).eventName);
+		attendanceRow.push_back(event.eventName);
 
 		// Status
 		std::string status;
@@ -663,7 +1281,7 @@ std::vector<std::vector<std::string>> DataManager::loadAttendanceMonitoring(Even
 		// Seat Id
 		std::string seatIds;
 		int count = 0;
-		for (Seat seat : getRegistrationFromRegistrationId(att.registrationId).seats) {
+		for (const Seat& seat : registration.seats) {
 			if (count != 0) {
 				seatIds += ", ";
 			}
@@ -682,17 +1300,36 @@ std::vector<std::vector<std::string>> DataManager::loadAttendanceMonitoring(Even
 	return attendanceData;
 }
 
+std::vector<std::vector<std::string>> DataManager::loadSectionAvailability(const std::string& eventId) {
+	std::vector<std::vector<std::string>> sectionData;
+	const SeatMap& seatMap = getSeatMapForEvent(eventId);
+	const VenueLayout& layout = seatMap.layout();
+
+	for (size_t i = 0; i < layout.sectionCount(); ++i) {
+		const VenueSection& section = layout.section(i);
+		sectionData.push_back({
+			std::to_string(i + 1),
+			section.name,
+			std::to_string(layout.firstRow(i)) + "-" + std::to_string(layout.lastRow(i)),
+			std::to_string(section.seatsPerRow),
+			std::to_string(seatMap.availableInSection(i)) + "/" + std::to_string(section.rows * section.seatsPerRow)
+		});
+	}
+	return sectionData;
+}
+
 std::vector<std::vector<std::string>> DataManager::loadSeatMonitoring(Event& event) {
 	std::vector<std::vector<std::string>> seatData;
-	std::vector<Registration> allRegistrations = getAllActiveRegistrations();
+	const EntityTable<User>& users = residentTable<User>(userFileName);
 
 	int seatNumber = 1;
-	for (Registration& reg : allRegistrations) {
-		if (reg.eventId != event.eventId || reg.registrationStatus == RegistrationStatus::CANCELLED) {
+	for (const Registration* regPtr : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, event.eventId)) {
+		const Registration& reg = *regPtr;
+		if (reg.registrationStatus == RegistrationStatus::CANCELLED) {
 			continue;
 		}
 
-		for (Seat seat : reg.seats) {
+		for (const Seat& seat : reg.seats) {
 			std::vector<std::string> seatRow;
 			// Number
 			seatRow.push_back(std::to_string(seatNumber));
@@ -708,7 +1345,7 @@ std::vector<std::vector<std::string>> DataManager::loadSeatMonitoring(Event& eve
 			seatRow.push_back(seat.column);
 
 			// Customer
-			seatRow.push_back(getUserFromUserId(reg.customerId).username);
+			seatRow.push_back(usernameOf(users, reg.customerId));
 			
 			seatData.push_back(seatRow);
 		}
@@ -718,4 +1355,104 @@ std::vector<std::vector<std::string>> DataManager::loadSeatMonitoring(Event& eve
 		seatData.push_back({ "No seat records found for this events", "", "", "", "" });
 	}
 	return seatData;
-}
\ No newline at end of file
+}
+
+std::unordered_map<std::string, const Registration*> DataManager::mapRegistrationsOfEvent(const std::string& eventId) {
+	std::unordered_map<std::string, const Registration*> eventRegistrations;
+	for (const Registration* reg : residentTable<Registration>(registrationFileName).findBy(EntityKeys<Registration>::BY_EVENT, eventId)) {
+		eventRegistrations.emplace(reg->registrationId, reg);
+	}
+	return eventRegistrations;
+}
+
+const std::string& DataManager::usernameOf(const EntityTable<User>& users, const std::string& userId) {
+	static const std::string unknownUser;
+	const User* user = users.find(userId);
+	return user ? user->username : unknownUser;
+}
+
+std::string DataManager::journalFileName(const std::string& filename) {
+	return filename + ".journal";
+}
+
+void DataManager::appendJournal(const std::string& lines, const std::string& filename) {
+	if (!FileManagement::appendFileDurably(journalFileName(filename), lines)) {
+		throw std::runtime_error("Unable to save data file " + filename + ".");
+	}
+}
+
+void DataManager::clearJournal(const std::string& filename) {
+	std::remove(journalFileName(filename).c_str());
+}
+
+bool DataManager::hasJournal(const std::string& filename) {
+	std::ifstream journal(journalFileName(filename));
+	return journal.is_open() && journal.peek() != std::ifstream::traits_type::eof();
+}
+
+std::string DataManager::snapshotStamp(const std::string& filename) {
+	return FileManagement::fileStamp(filename) + "|" + FileManagement::fileStamp(binaryFileName(filename));
+}
+
+void DataManager::writeSnapshotFile(const std::string& contents, const std::string& filename) {
+	if (!FileManagement::writeFileWithChecksum(filename, contents)) {
+		throw std::runtime_error("Unable to save data file " + filename + ".");
+	}
+}
+
+// Returns false when the snapshot does not exist.
+bool DataManager::readSnapshotFile(const std::string& filename, std::string& contents) {
+	if (!FileManagement::readFile(filename, contents)) {
+		return false;
+	}
+	if (!FileManagement::verifyChecksum(filename, contents)) {
+		throw std::runtime_error("Data file " + filename + " failed its checksum.");
+	}
+	return true;
+}
+
+// Finds the snapshot in the selected format, falling back to the other one.
+// When neither exists, path names the file a new snapshot would use.
+bool DataManager::readCurrentSnapshot(const std::string& filename, std::string& path, std::string& contents) {
+	bool binary = getSnapshotFormat() == SnapshotFormat::BINARY;
+	std::string preferred = binary ? binaryFileName(filename) : filename;
+	std::string fallback = binary ? filename : binaryFileName(filename);
+
+	if (readSnapshotFile(preferred, contents)) {
+		path = preferred;
+		return true;
+	}
+	if (readSnapshotFile(fallback, contents)) {
+		path = fallback;
+		return true;
+	}
+	path = preferred;
+	return false;
+}
+
+bool DataManager::matchesField(const nlohmann::json& record, const std::string& field, const std::string& value) {
+	auto it = record.find(field);
+	return it != record.end() && it->is_string() && it->get_ref<const std::string&>() == value;
+}
+
+std::string DataManager::binaryFileName(const std::string& filename) {
+	const std::string extension = ".json";
+	if (filename.size() > extension.size() &&
+		filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0) {
+		return filename.substr(0, filename.size() - extension.size()) + ".bin";
+	}
+	return filename + ".bin";
+}
+
+DataManager::SnapshotFormat& DataManager::currentSnapshotFormat() {
+	static SnapshotFormat format = SnapshotFormat::JSON;
+	return format;
+}
+
+void DataManager::setSnapshotFormat(SnapshotFormat format) {
+	currentSnapshotFormat() = format;
+}
+
+DataManager::SnapshotFormat DataManager::getSnapshotFormat() {
+	return currentSnapshotFormat();
+}
@@ -4,18 +4,184 @@
 #include <fstream>
 #include <sstream> 
 #include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
 #include <nlohmann/json.hpp>
 #include "Model.h"
+#include "EntityStore.h"
+#include "BinarySnapshot.h"
+#include "SnapshotView.h"
+#include "JsonRecordStream.h"
 #include "TimeUtils.h"
+#include "FileUtils.h"
+#include "IdAllocator.h"
+#include "SnowflakeId.h"
+#include "SeatMap.h"
+#include "SeatHoldQueue.h"
+#include "VoteTally.h"
+#include "VoteQuota.h"
+#include "TrendingSongs.h"
+#include "AudienceCounts.h"
 #include <iomanip>
 
 class DataManager {
 public:
+    static const size_t JOURNAL_COMPACT_THRESHOLD = 1000;
+
+    // Format used when a snapshot is written. Either format is read back, so
+    // switching converts each file the next time it is saved.
+    enum class SnapshotFormat { JSON, BINARY };
+    static void setSnapshotFormat(SnapshotFormat format);
+    static SnapshotFormat getSnapshotFormat();
+
+    // Recursive lock whose holder can let go of every level at once and take
+    // them back later, which DataManager does while it waits for an entity's
+    // file lock or writes a journal. Other threads then work on the store
+    // during that I/O, so a caller must not keep pointers into the tables
+    // across a write.
+    class StoreMutex {
+    public:
+        void lock();
+        void unlock();
+        // Releases all levels the calling thread holds and returns how many.
+        int releaseAll();
+        void reacquire(int levels);
+
+    private:
+        std::mutex mutex;
+        std::condition_variable released;
+        std::thread::id owner;
+        int depth = 0;
+    };
+
+    // The resident tables, indexes and journals are shared by every
+    // DataManager in the process and are not thread-safe themselves. Code
+    // that calls into them from more than one thread holds this lock.
+    static StoreMutex& storeMutex();
+
+    // Loads every entity table. Multi-threaded callers do this up front so
+    // no request has to load a table while it holds another entity's lock.
+    void loadAllTables();
+
     template <typename T>
     void saveData(const std::vector<T>& data, const std::string& filename) {
-        nlohmann::json j = data;
-        std::ofstream file(filename);
-        file << j.dump(4);
+        EntityLock lock(filename);
+        EntityTable<T>& table = EntityStore::table<T>(filename);
+        resetDerivedIndexes(data);
+        table.replaceAll(data);
+        writeSnapshot(data, filename);
+        clearJournal(filename);
+        markSnapshotWritten(table, filename);
+    }
+
+    // Inserts or replaces a single record by id. Only the record is appended to
+    // the entity's journal; the snapshot is rewritten once the journal is long enough.
+    template <typename T>
+    void saveRecord(const T& record, const std::string& filename) {
+        saveRecords(std::vector<T>{ record }, filename);
+    }
+
+    // Appends under the entity's lock, after picking up what other
+    // processes wrote, so the journal only ever grows by whole lines. The
+    // records go out in one append and one fsync; when this throws, none of
+    // them were saved.
+    template <typename T>
+    void saveRecords(const std::vector<T>& records, const std::string& filename) {
+        if (records.empty()) {
+            return;
+        }
+        EntityLock lock(filename);
+        refreshFromDisk<T>(filename);
+        EntityTable<T>& table = EntityStore::table<T>(filename);
+        // A long journal is folded before the append rather than after, so
+        // a failed compaction cannot fail a write that already reached disk.
+        // With the lock held, bytes past the last complete line can only be
+        // left by a crashed writer; folding the journal drops them too.
+        if (table.journalLength() >= JOURNAL_COMPACT_THRESHOLD
+            || FileManagement::fileSize(journalFileName(filename)) != table.journalOffset()) {
+            compact<T>(filename);
+        }
+
+        // The resident copy only changes once the lines are on disk, so a
+        // failed write leaves memory matching the file. Other threads keep
+        // using the store meanwhile; the entity lock keeps its writers out.
+        std::string lines;
+        for (const T& record : records) {
+            lines += nlohmann::json(record).dump();
+            lines += '\n';
+        }
+        {
+            StoreRelease unlocked;
+            appendJournal(lines, filename);
+        }
+        for (const T& record : records) {
+            updateDerivedIndexes(table.find(EntityKeys<T>::primary(record)), record);
+            table.upsert(record);
+        }
+        table.setJournalLength(table.journalLength() + records.size());
+        table.setJournalOffset(table.journalOffset() + lines.size());
+    }
+
+    // Applies records other processes have written to the file since this
+    // process read it: new journal lines are replayed, and a rewritten
+    // snapshot or journal reloads the table.
+    template <typename T>
+    void refreshFromDisk(const std::string& filename) {
+        EntityLock lock(filename);
+        EntityTable<T>& table = EntityStore::table<T>(filename);
+        if (!table.isLoaded()) {
+            residentTable<T>(filename);
+            return;
+        }
+        uint64_t journalSize = FileManagement::fileSize(journalFileName(filename));
+        if (table.snapshotStamp() != snapshotStamp(filename) || journalSize < table.journalOffset()) {
+            resetDerivedIndexes(table.all());
+            table = EntityTable<T>();
+            residentTable<T>(filename);
+        }
+        else if (journalSize > table.journalOffset()) {
+            replayJournal(table, filename);
+        }
+    }
+
+    // Claims the registration's seats and saves it. The seats are checked
+    // against everything other processes have booked; the write only goes
+    // ahead, under the registration file lock, once the check holds for the
+    // latest registrations, redone if they changed. Returns false with the seat ids
+    // already taken when any seat is occupied or outside the venue.
+    bool reserveSeats(const Registration& registration, std::vector<std::string>& takenSeats);
+
+    // One booking of a group order: either the seats to claim ("R3C7") or,
+    // when seatIds is empty, how many of the best available seats to take.
+    struct BookingRequest {
+        std::string customerId;
+        std::string eventId;
+        int seatCount = 0;
+        std::vector<std::string> seatIds;
+        RegistrationStatus status = RegistrationStatus::PENDING;
+    };
+
+    // Books every request in a single write, with the same conflict checks as
+    // reserveSeats. Either all registrations are saved and returned in booked,
+    // or none are and error names the first request that could not be met.
+    // Only SCHEDULED events whose start time is after registerTime can be booked.
+    bool bookGroup(const std::vector<BookingRequest>& requests, time_t registerTime,
+        std::vector<Registration>& booked, std::string& error);
+
+    // Folds the journal into the snapshot file, under the entity's lock and
+    // after picking up what other processes wrote.
+    template <typename T>
+    void compact(const std::string& filename) {
+        EntityLock lock(filename);
+        refreshFromDisk<T>(filename);
+        EntityTable<T>& table = EntityStore::table<T>(filename);
+        writeSnapshot(residentData<T>(filename), filename);
+        clearJournal(filename);
+        markSnapshotWritten(table, filename);
     }
 
     std::string userFileName = "users.json";
@@ -29,39 +195,124 @@ public:
 
     template <typename T>
     std::vector<T> loadData(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::ofstream newFile(filename);
-            return {};
-        }
-        nlohmann::json j;
-        try {
-            file >> j;
-            if (j.is_null()) {
-                return {};
+        return residentData<T>(filename);
+    }
+
+    // Rows of an entity file for read-only scans such as reports. A file that is
+    // not resident yet is memory-mapped when its binary snapshot is current;
+    // otherwise the view reads the resident rows.
+    template <typename T>
+    SnapshotView<T> viewData(const std::string& filename) {
+        if (!EntityStore::table<T>(filename).isLoaded() &&
+            getSnapshotFormat() == SnapshotFormat::BINARY && !hasJournal(filename)) {
+            std::string binaryFile = binaryFileName(filename);
+            auto file = std::make_shared<FileManagement::MappedFile>();
+            if (file->open(binaryFile) && !file->contents().empty()) {
+                if (!FileManagement::verifyChecksum(binaryFile, file->contents())) {
+                    throw std::runtime_error("Data file " + binaryFile + " failed its checksum.");
+                }
+                BinarySnapshot::TableView<T> table(file->contents());
+                return SnapshotView<T>(std::move(file), std::move(table));
             }
         }
-        catch (nlohmann::json::parse_error& e) {
-            return {};
+        return SnapshotView<T>(residentData<T>(filename));
+    }
+
+    // Records whose text field equals value, for example the registrations of
+    // one event. A resident table answers from memory; otherwise the snapshot
+    // is streamed and only matching records are built, without loading the table.
+    template <typename T>
+    std::vector<T> loadDataWhere(const std::string& filename, const std::string& field, const std::string& value) {
+        using Keys = EntityKeys<T>;
+        const EntityTable<T>& table = EntityStore::table<T>(filename);
+        std::vector<T> matches;
+
+        if (table.isLoaded()) {
+            for (int index = 0; index < Keys::INDEX_COUNT; ++index) {
+                if (field == Keys::secondaryField(index)) {
+                    for (const T* record : table.findBy(index, value)) {
+                        matches.push_back(*record);
+                    }
+                    return matches;
+                }
+            }
+            for (const T& record : table.all()) {
+                if (matchesField(nlohmann::json(record), field, value)) {
+                    matches.push_back(record);
+                }
+            }
+            return matches;
         }
-        return j.get<std::vector<T>>();
+
+        matches = readSnapshotWhere<T>(filename, field, value);
+        replayJournalWhere(matches, filename, field, value);
+        return matches;
     }
 
     std::string generateNewEventId();
     std::string generateNewRegistrationId();
     std::string generateNewAttendanceId();
+    std::vector<std::string> generateNewAttendanceIds(size_t count);
+    std::vector<std::string> generateNewRegistrationIds(size_t count);
     std::string generateNewVoteId();
+    std::vector<std::string> generateNewVoteIds(size_t count);
     std::string generateNewRefundId();
+    std::string generateNewPaymentId();
+    std::string generateNewPerformanceId();
+    std::string generateNewSongId();
+    std::string generateNewUserId(UserType userType);
     int getAvailableSeats(const std::string& eventId);
     Event getEventFromEventId(const std::string& targetEventId);
     std::vector<Seat> getOccupiedSeatsForEvent(const std::string& eventId);
+    // Seat bitmap of the event, built from its registrations on first use and
+    // kept current by every registration write. The reference stays valid
+    // until the next registration write or change to the event's layout.
+    const SeatMap& getSeatMapForEvent(const std::string& eventId);
+    // Live vote totals and top songs per event, counting the votes of
+    // registrations that are not refunded. Built from the tables on first use
+    // and then updated by every vote, registration and payment write.
+    const VoteTally& getVoteTally();
+    // The tally's per-song totals, readable from any thread without the
+    // store lock. Their snapshot fails until getVoteTally() has built them.
+    static const SongCounters& getVoteCounters();
+    // Seats and votes cast of the registration, kept current by every
+    // registration and vote write.
+    VoteQuota::Entry getVoteQuota(const std::string& registrationId);
+    // Recent votes per event in one-minute sketches, for "trending now"
+    // lists. Built from the vote times on first use and then fed every new
+    // ballot.
+    const TrendingSongs& getTrendingSongs();
+    // Distinct voting and attending customers per event and overall. Built
+    // from the tables on first use and then fed every vote and attendance.
+    const AudienceCounts& getAudienceCounts();
+    // Saves the vote if its registration has votes left, assigning a vote id
+    // when it has none. The check and the write happen under the vote file
+    // lock after picking up other processes' votes, so two ballots can never
+    // both take the last vote. Returns false with the reason otherwise.
+    bool castVote(Vote& vote, std::string& error);
+    // castVote for many ballots under one lock and one journal append. Each
+    // ballot is checked against the votes left after the earlier ones in the
+    // batch; errors[i] stays empty for the saved ones. Returns how many were
+    // saved.
+    size_t castVotes(std::vector<Vote>& votes, std::vector<std::string>& errors);
+    bool isSeatOccupied(const std::string& eventId, const std::string& row, const std::string& column);
+    // Fills one row per venue row, each as wide as its section: 1 present, 0 absent, -1 not booked.
     void getAttendanceFromEvent(std::vector<std::vector<int>>& venueAttendance, Event& event);
     Registration getRegistrationFromRegistrationId(const std::string& registrationId);
     void updateEventStatus(time_t& currentDateTime);
     void updateAttendanceStatus();
+    // Cancels unpaid registrations whose seat hold ran out before
+    // currentDateTime, returning their seats. Cheap when nothing is due, so
+    // menus call it on every pass. Returns the number of holds released.
+    size_t expireSeatHolds(time_t currentDateTime);
     std::vector<std::vector<std::string>> loadScheduledAndOngoingDataOfUser(const std::string& userId);
     Registration getRegistrationFromEventId(const std::string& eventId, const std::string& userId);
     std::vector<Registration> getRegistrationsForEvent(const std::string& eventId);
+    std::vector<Registration> getRegistrationsForCustomer(const std::string& customerId);
+    std::vector<Payment> getPaymentsForRegistration(const std::string& registrationId);
+    // Payments of every registration for the event, cancelled ones included.
+    std::vector<Payment> getPaymentsForEvent(const std::string& eventId);
+    std::vector<Attendance> getAttendancesForRegistration(const std::string& registrationId);
     User getUserFromUserId(const std::string& userId);
     Payment getPaymentFromPaymentId(const std::string& paymentId);
     std::vector<std::vector<std::string>> loadScheduledAndOngoingDataOfOrganizer(std::string& userId);
@@ -69,7 +320,8 @@ public:
     void loadRefundedSalesOfEvent(std::vector<std::vector<std::string>>& sales, Event& event);
     std::vector<std::vector<std::string>> loadAttendanceMonitoring(Event& event);
     std::vector<std::vector<std::string>> loadSeatMonitoring(Event& event);
-    void updateRegistrationStatus(time_t& currentDateTime);
+    // One row per venue section: number, name, row range, seats per row, available/total.
+    std::vector<std::vector<std::string>> loadSectionAvailability(const std::string& eventId);
     std::vector<Event> getAllScheduledEvent();
 
     std::vector<User> getAllActiveUsers();
@@ -80,4 +332,285 @@ public:
     std::vector<Performance> getAllActivePerformances();
     std::vector<Vote> getAllActiveVotes();
     std::vector<Attendance> getAllActiveAttendances();
+
+private:
+    std::unordered_map<std::string, const Registration*> mapRegistrationsOfEvent(const std::string& eventId);
+    static const std::string& usernameOf(const EntityTable<User>& users, const std::string& userId);
+
+    static std::string journalFileName(const std::string& filename);
+    // Appends the lines and forces them to disk; throws when that fails.
+    static void appendJournal(const std::string& lines, const std::string& filename);
+    static void clearJournal(const std::string& filename);
+    static bool hasJournal(const std::string& filename);
+    static std::string snapshotStamp(const std::string& filename);
+    bool findSeatConflicts(const Registration& registration, std::vector<std::string>& takenSeats);
+    // Runs plan and saves the records it fills, redoing it under the
+    // registration file lock when other writers got in first; stops when
+    // plan returns false.
+    bool commitSeatPlan(const std::function<bool(std::vector<Registration>&)>& plan);
+    static std::string binaryFileName(const std::string& filename);
+    static SnapshotFormat& currentSnapshotFormat();
+    static void writeSnapshotFile(const std::string& contents, const std::string& filename);
+    static bool readSnapshotFile(const std::string& filename, std::string& contents);
+    static bool readCurrentSnapshot(const std::string& filename, std::string& path, std::string& contents);
+    static bool matchesField(const nlohmann::json& record, const std::string& field, const std::string& value);
+
+    // Indexes derived from one entity type (such as the seat maps built from
+    // registrations) follow the table through these hooks.
+    template <typename T>
+    void updateDerivedIndexes(const T*, const T&) {}
+    template <typename T>
+    void resetDerivedIndexes(const std::vector<T>&) {}
+    void updateDerivedIndexes(const Registration* before, const Registration& after);
+    void resetDerivedIndexes(const std::vector<Registration>&);
+    void updateDerivedIndexes(const Vote* before, const Vote& after);
+    void resetDerivedIndexes(const std::vector<Vote>&);
+    void updateDerivedIndexes(const Payment* before, const Payment& after);
+    void resetDerivedIndexes(const std::vector<Payment>&);
+    void updateDerivedIndexes(const Attendance* before, const Attendance& after);
+    void resetDerivedIndexes(const std::vector<Attendance>&);
+    static std::unordered_map<std::string, SeatMap>& seatMaps();
+    static SeatHoldQueue& seatHolds();
+    static VoteTally& voteTally();
+    static VoteQuota& voteQuotas();
+    static TrendingSongs& trendingSongs();
+    static AudienceCounts& audienceCounts();
+    bool isRegistrationRefunded(const std::string& registrationId, const Payment* replacing = nullptr);
+    bool votesAreCounted(const std::string& registrationId);
+    void tallyVotesOf(const std::string& registrationId, const std::string& eventId, bool add);
+
+    // Lets go of the store lock for the calling thread's scope, if it holds it.
+    class StoreRelease {
+    public:
+        StoreRelease() : levels(storeMutex().releaseAll()) {}
+        ~StoreRelease() { storeMutex().reacquire(levels); }
+        StoreRelease(const StoreRelease&) = delete;
+        StoreRelease& operator=(const StoreRelease&) = delete;
+
+    private:
+        int levels;
+    };
+
+    // Guards one entity's files: threads of this process through a mutex,
+    // other processes through "<file>.lock". Writers hold it while appending
+    // or compacting, and tables are loaded and refreshed under it, so a
+    // snapshot and its journal are always read as a pair. The thread holding
+    // it may take it again. It is never waited for with the store lock held.
+    class EntityLock {
+    public:
+        explicit EntityLock(const std::string& filename);
+        ~EntityLock();
+        EntityLock(const EntityLock&) = delete;
+        EntityLock& operator=(const EntityLock&) = delete;
+
+    private:
+        struct Holder;
+        Holder& holder;
+
+        static Holder& holderOf(const std::string& filename);
+    };
+
+    // A torn journal tail is left in place for the next writer to drop.
+    template <typename T>
+    const EntityTable<T>& residentTable(const std::string& filename) {
+        EntityTable<T>& table = EntityStore::table<T>(filename);
+        if (!table.isLoaded()) {
+            EntityLock lock(filename);
+            table.setSnapshotStamp(snapshotStamp(filename));
+            table.setJournalOffset(0);
+            table.setJournalLength(0);
+            table.replaceAll(readSnapshot<T>(filename));
+            replayJournal(table, filename);
+        }
+        return table;
+    }
+
+    // Applies every complete journal line past the table's journal offset.
+    // Returns true when the last line is cut short, either by a crash
+    // mid-append or by another process still writing it.
+    template <typename T>
+    bool replayJournal(EntityTable<T>& table, const std::string& filename) {
+        std::ifstream journal(journalFileName(filename), std::ios::binary);
+        journal.seekg(static_cast<std::streamoff>(table.journalOffset()));
+        size_t replayed = table.journalLength();
+        size_t offset = table.journalOffset();
+        bool tornTail = false;
+        std::string line;
+        while (std::getline(journal, line)) {
+            if (journal.eof()) {
+                tornTail = true;
+                break;
+            }
+            size_t lineBytes = line.size() + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                offset += lineBytes;
+                continue;
+            }
+            nlohmann::json j = nlohmann::json::parse(line, nullptr, false);
+            if (j.is_discarded() || !j.is_object()) {
+                tornTail = true;
+                break;
+            }
+            T record = j.get<T>();
+            updateDerivedIndexes(table.find(EntityKeys<T>::primary(record)), record);
+            table.upsert(record);
+            replayed++;
+            offset += lineBytes;
+        }
+        table.setJournalLength(replayed);
+        table.setJournalOffset(offset);
+        return tornTail;
+    }
+
+    template <typename T>
+    void markSnapshotWritten(EntityTable<T>& table, const std::string& filename) {
+        table.setJournalLength(0);
+        table.setJournalOffset(0);
+        table.setSnapshotStamp(snapshotStamp(filename));
+    }
+
+    template <typename T>
+    const std::vector<T>& residentData(const std::string& filename) {
+        return residentTable<T>(filename).all();
+    }
+
+    template <typename T>
+    long long highestIdNumber(const std::string& filename, const std::string& prefix) {
+        long long highest = 0;
+        for (const T& record : residentData<T>(filename)) {
+            highest = std::max(highest, IdAllocator::numberOf(EntityKeys<T>::primary(record), prefix));
+        }
+        return highest;
+    }
+
+    // count consecutive ids with prefix from IdAllocator. The counter is seeded
+    // from the highest id already in filename the first time prefix is used.
+    template <typename T>
+    std::vector<std::string> generateNewIds(const std::string& filename, const std::string& prefix, size_t count, int width = 3) {
+        long long first = IdAllocator::reserve(prefix, static_cast<long long>(count),
+            [this, &filename, &prefix] { return highestIdNumber<T>(filename, prefix); });
+
+        std::vector<std::string> ids;
+        ids.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            ids.push_back(IdAllocator::format(prefix, first + static_cast<long long>(i), width));
+        }
+        return ids;
+    }
+
+    template <typename T>
+    void writeSnapshot(const std::vector<T>& data, const std::string& filename) {
+        if (getSnapshotFormat() == SnapshotFormat::BINARY) {
+            writeSnapshotFile(BinarySnapshot::encode(data), binaryFileName(filename));
+            FileManagement::removeFileWithChecksum(filename);
+        }
+        else {
+            nlohmann::json j = data;
+            writeSnapshotFile(j.dump(4), filename);
+            FileManagement::removeFileWithChecksum(binaryFileName(filename));
+        }
+    }
+
+    template <typename T>
+    std::vector<T> readSnapshot(const std::string& filename) {
+        std::string path;
+        std::string contents;
+        if (!readCurrentSnapshot(filename, path, contents)) {
+            std::ofstream newFile(path);
+            return {};
+        }
+        return decodeSnapshot<T>(contents, path);
+    }
+
+    template <typename T>
+    std::vector<T> decodeSnapshot(const std::string& contents, const std::string& filename) {
+        if (BinarySnapshot::isBinarySnapshot(contents)) {
+            return BinarySnapshot::decode<T>(contents);
+        }
+        if (contents.find_first_not_of(" \t\r\n") == std::string::npos) {
+            return {};
+        }
+        std::vector<T> rows;
+        try {
+            JsonStream::forEachRecord<T>(contents, [&](T&& record) { rows.push_back(std::move(record)); });
+        }
+        catch (const std::runtime_error& e) {
+            throw std::runtime_error("Data file " + filename + " is corrupted: " + e.what());
+        }
+        return rows;
+    }
+
+    template <typename T>
+    std::vector<T> readSnapshotWhere(const std::string& filename, const std::string& field, const std::string& value) {
+        std::string path;
+        std::string contents;
+        if (!readCurrentSnapshot(filename, path, contents) || contents.find_first_not_of(" \t\r\n") == std::string::npos) {
+            return {};
+        }
+        if (BinarySnapshot::isBinarySnapshot(contents)) {
+            return BinarySnapshot::TableView<T>(contents).rowsWhere(field, value);
+        }
+        std::vector<T> rows;
+        try {
+            JsonStream::forEachRecordWhere<T>(contents, field, value, [&](T&& record) { rows.push_back(std::move(record)); });
+        }
+        catch (const std::runtime_error& e) {
+            throw std::runtime_error("Data file " + path + " is corrupted: " + e.what());
+        }
+        return rows;
+    }
+
+    // Brings records read from the snapshot up to date with the journal: a
+    // journaled record replaces the snapshot one, and leaves the result when it
+    // no longer matches.
+    template <typename T>
+    void replayJournalWhere(std::vector<T>& matches, const std::string& filename, const std::string& field, const std::string& value) {
+        std::unordered_map<std::string, size_t> positions;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            positions.emplace(EntityKeys<T>::primary(matches[i]), i);
+        }
+        std::vector<bool> dropped(matches.size(), false);
+
+        std::ifstream journal(journalFileName(filename));
+        std::string line;
+        while (std::getline(journal, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            nlohmann::json j = nlohmann::json::parse(line, nullptr, false);
+            if (j.is_discarded() || !j.is_object()) {
+                break;
+            }
+            T record = j.get<T>();
+            auto it = positions.find(EntityKeys<T>::primary(record));
+            if (matchesField(j, field, value)) {
+                if (it == positions.end()) {
+                    positions.emplace(EntityKeys<T>::primary(record), matches.size());
+                    matches.push_back(std::move(record));
+                    dropped.push_back(false);
+                }
+                else {
+                    matches[it->second] = std::move(record);
+                    dropped[it->second] = false;
+                }
+            }
+            else if (it != positions.end()) {
+                dropped[it->second] = true;
+            }
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < matches.size(); ++i) {
+            if (!dropped[i]) {
+                if (kept != i) {
+                    matches[kept] = std::move(matches[i]);
+                }
+                kept++;
+            }
+        }
+        matches.resize(kept);
+    }
 };
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include "DataManager.h"
+#include "RequestEngine.h"
+#include "ShardedExecutor.h"
+#include "VoteIngestor.h"
+#include "SeatHoldReaper.h"
+
+// Runs JSON-lines requests against the data files without the menus.
+//   RequestEngine                              reads stdin, writes stdout
+//   RequestEngine requests.jsonl               reads the file, writes stdout
+//   RequestEngine requests.jsonl replies.jsonl
+//   RequestEngine --threads 8 requests.jsonl replies.jsonl
+// One reply line is written per non-empty request line, in the same order.
+// Requests are spread over worker threads by event; requests for the same
+// event run in file order.
+
+static const size_t MAX_IN_FLIGHT = 4096;
+// Unpaid holds are released this often while requests are read.
+static const std::chrono::seconds HOLD_REAP_INTERVAL(60);
+
+static void writeReply(std::deque<std::future<std::string>>& pending, std::ostream& output) {
+    output << pending.front().get() << '\n';
+    pending.pop_front();
+}
+
+int main(int argc, char* argv[]) {
+    size_t threads = std::thread::hardware_concurrency();
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        }
+        else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() > 2) {
+        std::cerr << "Usage: RequestEngine [--threads N] [requests.jsonl] [replies.jsonl]\n";
+        return 1;
+    }
+    std::ios::sync_with_stdio(false);
+
+    std::ifstream inputFile;
+    if (files.size() > 0) {
+        inputFile.open(files[0]);
+        if (!inputFile) {
+            std::cerr << "Unable to open " << files[0] << ".\n";
+            return 1;
+        }
+    }
+    std::ofstream outputFile;
+    if (files.size() > 1) {
+        outputFile.open(files[1], std::ios::trunc);
+        if (!outputFile) {
+            std::cerr << "Unable to open " << files[1] << ".\n";
+            return 1;
+        }
+    }
+    std::istream& input = files.size() > 0 ? static_cast<std::istream&>(inputFile) : std::cin;
+    std::ostream& output = files.size() > 1 ? static_cast<std::ostream&>(outputFile) : std::cout;
+    bool interactive = files.empty();
+
+    try {
+        DataManager dm;
+        dm.expireSeatHolds(time(nullptr));
+        RequestEngine engine(dm);
+        // Each worker waits for its vote's ack, so at most one vote per worker
+        // is queued and holding a group open would only stall them: groups
+        // are the votes that arrive while the previous one is written.
+        // Declared before the executor so it outlives the jobs waiting on it.
+        VoteIngestor ingestor(dm, threads, std::chrono::milliseconds(0));
+        engine.setVoteIngestor(&ingestor);
+        ShardedExecutor executor(threads);
+        SeatHoldReaper reaper(engine, executor, HOLD_REAP_INTERVAL);
+        std::deque<std::future<std::string>> pending;
+
+        std::string line;
+        while (std::getline(input, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            nlohmann::json request = nlohmann::json::parse(line, nullptr, false);
+            if (request.is_discarded()) {
+                pending.push_back(executor.submit("", [&engine, line] { return engine.handleLine(line); }));
+            }
+            else {
+                std::string key = engine.shardKey(request);
+                // The registration may come from a request still queued on
+                // another shard, and a report over several events must see
+                // them all; finish those first.
+                if (key.empty() && request.is_object() && !pending.empty()) {
+                    while (!pending.empty()) {
+                        writeReply(pending, output);
+                    }
+                    key = engine.shardKey(request);
+                }
+                pending.push_back(executor.submit(key, [&engine, request] { return engine.handle(request).dump(); }));
+            }
+
+            // Interactive callers wait for each reply; files are flushed once.
+            while (!pending.empty() && (interactive || pending.size() >= MAX_IN_FLIGHT)) {
+                writeReply(pending, output);
+            }
+            if (interactive) {
+                output.flush();
+            }
+        }
+        while (!pending.empty()) {
+            writeReply(pending, output);
+        }
+        output.flush();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
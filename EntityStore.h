@@ -0,0 +1,244 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
+#include "Model.h"
+
+// Key extractors for every entity type kept in the store. primary() is the
+// record id; secondary() returns the foreign key used by each secondary index
+// and secondaryField() its JSON field name.
+template <typename T>
+struct EntityKeys;
+
+template <>
+struct EntityKeys<User> {
+    enum Index { INDEX_COUNT };
+    static const std::string& primary(const User& user) { return user.userId; }
+    static const std::string& secondary(const User& user, int) { return user.userId; }
+    static const char* secondaryField(int) { return "userId"; }
+};
+
+template <>
+struct EntityKeys<Event> {
+    enum Index { BY_ORGANIZER, INDEX_COUNT };
+    static const std::string& primary(const Event& event) { return event.eventId; }
+    static const std::string& secondary(const Event& event, int) { return event.organizerId; }
+    static const char* secondaryField(int) { return "organizerId"; }
+};
+
+template <>
+struct EntityKeys<Registration> {
+    enum Index { BY_EVENT, BY_CUSTOMER, INDEX_COUNT };
+    static const std::string& primary(const Registration& reg) { return reg.registrationId; }
+    static const std::string& secondary(const Registration& reg, int index) {
+        return index == BY_EVENT ? reg.eventId : reg.customerId;
+    }
+    static const char* secondaryField(int index) { return index == BY_EVENT ? "eventId" : "customerId"; }
+};
+
+template <>
+struct EntityKeys<Payment> {
+    enum Index { BY_REGISTRATION, INDEX_COUNT };
+    static const std::string& primary(const Payment& payment) { return payment.paymentId; }
+    static const std::string& secondary(const Payment& payment, int) { return payment.registrationId; }
+    static const char* secondaryField(int) { return "registrationId"; }
+};
+
+template <>
+struct EntityKeys<Refund> {
+    enum Index { BY_PAYMENT, INDEX_COUNT };
+    static const std::string& primary(const Refund& refund) { return refund.refundId; }
+    static const std::string& secondary(const Refund& refund, int) { return refund.paymentId; }
+    static const char* secondaryField(int) { return "paymentId"; }
+};
+
+template <>
+struct EntityKeys<Performance> {
+    enum Index { BY_EVENT, INDEX_COUNT };
+    static const std::string& primary(const Performance& perf) { return perf.performanceId; }
+    static const std::string& secondary(const Performance& perf, int) { return perf.eventId; }
+    static const char* secondaryField(int) { return "eventId"; }
+};
+
+template <>
+struct EntityKeys<Vote> {
+    enum Index { BY_REGISTRATION, INDEX_COUNT };
+    static const std::string& primary(const Vote& vote) { return vote.voteId; }
+    static const std::string& secondary(const Vote& vote, int) { return vote.registrationId; }
+    static const char* secondaryField(int) { return "registrationId"; }
+};
+
+template <>
+struct EntityKeys<Attendance> {
+    enum Index { BY_REGISTRATION, INDEX_COUNT };
+    static const std::string& primary(const Attendance& att) { return att.attendanceId; }
+    static const std::string& secondary(const Attendance& att, int) { return att.registrationId; }
+    static const char* secondaryField(int) { return "registrationId"; }
+};
+
+template <typename T>
+class EntityTable {
+public:
+    using Keys = EntityKeys<T>;
+
+    bool isLoaded() const {
+        return loaded;
+    }
+
+    const std::vector<T>& all() const {
+        return rows;
+    }
+
+    void replaceAll(const std::vector<T>& data) {
+        rows = data;
+        loaded = true;
+        rebuildIndexes();
+        touch();
+    }
+
+    void replaceAll(std::vector<T>&& data) {
+        rows = std::move(data);
+        loaded = true;
+        rebuildIndexes();
+        touch();
+    }
+
+    // Inserts the record, or replaces the existing record with the same id,
+    // keeping every index in step. Returns the row position.
+    size_t upsert(const T& record) {
+        touch();
+        const std::string& id = Keys::primary(record);
+        auto it = primaryIndex.find(id);
+        if (it == primaryIndex.end()) {
+            rows.push_back(record);
+            size_t position = rows.size() - 1;
+            primaryIndex.emplace(id, position);
+            for (int index = 0; index < Keys::INDEX_COUNT; ++index) {
+                secondaryIndexes[index][Keys::secondary(record, index)].push_back(position);
+            }
+            return position;
+        }
+
+        size_t position = it->second;
+        for (int index = 0; index < Keys::INDEX_COUNT; ++index) {
+            const std::string& oldKey = Keys::secondary(rows[position], index);
+            const std::string& newKey = Keys::secondary(record, index);
+            if (oldKey == newKey) {
+                continue;
+            }
+            std::vector<size_t>& oldPositions = secondaryIndexes[index][oldKey];
+            oldPositions.erase(std::remove(oldPositions.begin(), oldPositions.end(), position), oldPositions.end());
+            std::vector<size_t>& newPositions = secondaryIndexes[index][newKey];
+            newPositions.insert(std::lower_bound(newPositions.begin(), newPositions.end(), position), position);
+        }
+        rows[position] = record;
+        return position;
+    }
+
+    // Changes with every write to the rows and never goes back to an earlier
+    // value, even across a reload, so a caller can tell whether anything
+    // changed since it last looked.
+    size_t revision() const {
+        return revisionNumber;
+    }
+
+    // Number of records appended to the journal since the last snapshot.
+    size_t journalLength() const {
+        return journalRecords;
+    }
+
+    void setJournalLength(size_t length) {
+        journalRecords = length;
+    }
+
+    // Bytes of the journal already applied to the rows, and the stamp of the
+    // snapshot they were read from. Writes by other processes show up as a
+    // longer journal or a new stamp.
+    size_t journalOffset() const {
+        return journalBytes;
+    }
+
+    void setJournalOffset(size_t offset) {
+        journalBytes = offset;
+    }
+
+    const std::string& snapshotStamp() const {
+        return stamp;
+    }
+
+    void setSnapshotStamp(const std::string& snapshotStamp) {
+        stamp = snapshotStamp;
+    }
+
+    // Returns the first record with the given id, or nullptr.
+    const T* find(const std::string& id) const {
+        auto it = primaryIndex.find(id);
+        if (it == primaryIndex.end()) {
+            return nullptr;
+        }
+        return &rows[it->second];
+    }
+
+    // Returns every record whose secondary key matches, in file order.
+    std::vector<const T*> findBy(int index, const std::string& key) const {
+        std::vector<const T*> matches;
+        auto it = secondaryIndexes[index].find(key);
+        if (it != secondaryIndexes[index].end()) {
+            matches.reserve(it->second.size());
+            for (size_t position : it->second) {
+                matches.push_back(&rows[position]);
+            }
+        }
+        return matches;
+    }
+
+private:
+    bool loaded = false;
+    size_t journalRecords = 0;
+    size_t journalBytes = 0;
+    std::string stamp;
+    size_t revisionNumber = 0;
+    std::vector<T> rows;
+    std::unordered_map<std::string, size_t> primaryIndex;
+    std::unordered_map<std::string, std::vector<size_t>> secondaryIndexes[Keys::INDEX_COUNT + 1];
+
+    void touch() {
+        static size_t lastRevision = 0;
+        revisionNumber = ++lastRevision;
+    }
+
+    void rebuildIndexes() {
+        primaryIndex.clear();
+        primaryIndex.reserve(rows.size());
+        for (auto& index : secondaryIndexes) {
+            index.clear();
+        }
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            primaryIndex.emplace(Keys::primary(rows[i]), i);
+            for (int index = 0; index < Keys::INDEX_COUNT; ++index) {
+                secondaryIndexes[index][Keys::secondary(rows[i], index)].push_back(i);
+            }
+        }
+    }
+};
+
+// Process-wide resident copy of every entity file. Every DataManager instance
+// shares it, so a file is parsed once and later getters are served from memory.
+class EntityStore {
+public:
+    template <typename T>
+    static EntityTable<T>& table(const std::string& filename) {
+        static std::unordered_map<std::string, EntityTable<T>> tables;
+        return tables[normalizeKey(filename)];
+    }
+
+    static std::string normalizeKey(const std::string& filename) {
+        std::string key = filename;
+        std::transform(key.begin(), key.end(), key.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return key;
+    }
+};
@@ -8,8 +8,9 @@
 namespace EventBooking {
 	void EventBooking::run(User& user, time_t& currentDateTime) {
 		this->user = user;
-		this->events = dm.getAllScheduledEvent();
 		this->currentDateTime = currentDateTime;
+		dm.expireSeatHolds(currentDateTime);
+		this->events = dm.getAllScheduledEvent();
 		showMenu();
 	}
 
@@ -127,17 +128,8 @@ namespace EventBooking {
 		return true;
 	}
 
-	void EventBooking::printSeatMenu(const std::vector<std::string>& currentSelection) {
-		std::vector<std::vector<bool>> venue_seats(10, std::vector<bool>(10, false));
-
-		std::vector<Seat> occupied_seats = dm.getOccupiedSeatsForEvent(event.eventId);
-		for (const auto& seat : occupied_seats) {
-			int rowIndex = std::stoi(seat.row) - 1;
-			int colIndex = std::stoi(seat.column) - 1;
-			if (rowIndex >= 0 && rowIndex < 10 && colIndex >= 0 && colIndex < 10) {
-				venue_seats[rowIndex][colIndex] = true;
-			}
-		}
+	void EventBooking::printSeatMenu(const std::vector<std::string>& currentSelection, size_t section) {
+		SeatMap seatMap = dm.getSeatMapForEvent(event.eventId);
 
 		for (const auto& seatId : currentSelection) {
 			size_t r_pos = seatId.find('R');
@@ -145,43 +137,137 @@ namespace EventBooking {
 			if (r_pos != std::string::npos && c_pos != std::string::npos) {
 				std::string rowStr = seatId.substr(r_pos + 1, c_pos - r_pos - 1);
 				std::string colStr = seatId.substr(c_pos + 1);
-				int rowIndex = std::stoi(rowStr) - 1;
-				int colIndex = std::stoi(colStr) - 1;
+				seatMap.occupy(rowStr, colStr);
+			}
+		}
+
+		const VenueLayout& layout = seatMap.layout();
+		if (layout.sectionCount() == 0) {
+			output.printSeatingChart(seatMap.toGrid());
+			return;
+		}
+		int firstRow = layout.firstRow(section);
+		output.printSeatingChart(seatMap.toGrid(firstRow, layout.lastRow(section)), firstRow);
+	}
+
+	// Returns false when the user cancels.
+	bool EventBooking::selectSection(size_t& section) {
+		const VenueLayout& layout = dm.getSeatMapForEvent(event.eventId).layout();
+		section = 0;
+		if (layout.sectionCount() <= 1) {
+			return true;
+		}
+
+		while (true) {
+			displayMenu();
+			output.displayTable({ "No.", "Section", "Rows", "Seats/Row", "Available" }, dm.loadSectionAvailability(event.eventId));
 
-				if (rowIndex >= 0 && rowIndex < 10 && colIndex >= 0 && colIndex < 10) {
-					venue_seats[rowIndex][colIndex] = true;
-				}
+			std::string input;
+			output.print("Select section (1-" + std::to_string(layout.sectionCount()) + "): ");
+			std::getline(std::cin, input);
+
+			if (validation.shouldCancel(input)) {
+				return false;
 			}
+			if (validation.validateMenuInput(1, static_cast<int>(layout.sectionCount()), input)) {
+				section = std::stoi(input) - 1;
+				return true;
+			}
+			output.println("Invalid section!", OutputManager::Color::RED);
+			system("pause");
+		}
+	}
+
+	// Offers the best free block for the whole party. Returns true when the
+	// customer accepts it, false to pick seats by hand.
+	bool EventBooking::autoSelectSeats() {
+		displayMenu();
+		output.print("Auto-select the best available seats? (Y/N): ");
+		std::string answer;
+		std::getline(std::cin, answer);
+		if (answer != "y" && answer != "Y") {
+			return false;
+		}
+
+		size_t section;
+		if (!selectSection(section)) {
+			return false;
+		}
+		SeatMap seatMap = dm.getSeatMapForEvent(event.eventId);
+		int sectionIndex = seatMap.layout().sectionCount() > 1 ? static_cast<int>(section) : -1;
+		std::vector<std::pair<int, int>> seats = seatMap.bestAvailable(ticketBuy, sectionIndex);
+		if (seats.empty()) {
+			output.println("Not enough seats are free there. Please pick your seats manually.", OutputManager::Color::RED);
+			system("pause");
+			return false;
 		}
 
-		output.printSeatingChart(venue_seats);
+		selectedSeats.clear();
+		for (const auto& seat : seats) {
+			selectedSeats.push_back("R" + std::to_string(seat.first) + "C" + std::to_string(seat.second));
+		}
+
+		displayMenu();
+		printSeatMenu(selectedSeats, section);
+		output.print("Proposed seats:");
+		for (const auto& seatId : selectedSeats) {
+			output.print(" " + seatId);
+		}
+		output.println("");
+		output.print("Accept these seats? (Y/N): ");
+		std::getline(std::cin, answer);
+		if (answer == "y" || answer == "Y") {
+			return true;
+		}
+		selectedSeats.clear();
+		return false;
 	}
 
 	void EventBooking::selectSeats() {
+		if (autoSelectSeats()) {
+			showPaymentOptions();
+			return;
+		}
+
 		for (int i = 0; i < ticketBuy; i++) {
+			size_t section;
+			if (!selectSection(section)) {
+				return;
+			}
+
 			displayMenu();
-			printSeatMenu(selectedSeats);
+			printSeatMenu(selectedSeats, section);
+
+			VenueLayout layout = dm.getSeatMapForEvent(event.eventId).layout();
+			int firstRow = 1, lastRow = 1, seatsPerRow = 1;
+			if (layout.sectionCount() > 0) {
+				firstRow = layout.firstRow(section);
+				lastRow = layout.lastRow(section);
+				seatsPerRow = layout.section(section).seatsPerRow;
+			}
+			std::string rowRange = std::to_string(firstRow) + "-" + std::to_string(lastRow);
+			std::string columnRange = "1-" + std::to_string(seatsPerRow);
 
 			output.println("Select seat " + std::to_string(i + 1) + " of " + std::to_string(ticketBuy),
 				OutputManager::Color::CYAN);
 
 			std::string row, col;
-			output.print("Enter row number (1-10): ");
+			output.print("Enter row number (" + rowRange + "): ");
 			std::getline(std::cin, row);
 
 			if (validation.shouldCancel(row)) {
 				return;
 			}
 
-			output.print("Enter column number (1-10): ");
+			output.print("Enter column number (" + columnRange + "): ");
 			std::getline(std::cin, col);
 
 			if (validation.shouldCancel(col)) {
 				return;
 			}
 
-			if (!validation.validateMenuInput(1, 10, row) || !validation.validateMenuInput(1, 10, col)) {
-				output.println("Invalid row or column! Please enter numbers between 1 and 10.",
+			if (!validation.validateMenuInput(firstRow, lastRow, row) || !validation.validateMenuInput(1, seatsPerRow, col)) {
+				output.println("Invalid row or column! Please enter a row in " + rowRange + " and a column in " + columnRange + ".",
 					OutputManager::Color::RED);
 				system("pause");
 				i--;
@@ -212,15 +298,7 @@ namespace EventBooking {
 	}
 
 	bool EventBooking::isSeatAvailable(const std::string& row, const std::string& column) {
-		std::vector<Seat> occupied_seats = dm.getOccupiedSeatsForEvent(event.eventId);
-
-		for (const auto& seat : occupied_seats) {
-			if (seat.row == row && seat.column == column) {
-				return false;
-			}
-		}
-
-		return true;
+		return !dm.isSeatOccupied(event.eventId, row, column);
 	}
 
 	void EventBooking::showPaymentOptions() {
@@ -252,13 +330,16 @@ namespace EventBooking {
 
 		if (choice == "1") {
 			Registration newRegistration = completeRegistration(RegistrationStatus::PENDING);
-			proceedToPayment(newRegistration);
+			if (!newRegistration.registrationId.empty()) {
+				proceedToPayment(newRegistration);
+			}
 		}
 		else if (choice == "2") {
-			completeRegistration(RegistrationStatus::PENDING);
-			output.println("Registration saved! You can complete payment later from the Payment System.",
-				OutputManager::Color::CYAN);
-			system("pause");
+			if (!completeRegistration(RegistrationStatus::PENDING).registrationId.empty()) {
+				output.println("Registration saved! You can complete payment later from the Payment System.",
+					OutputManager::Color::CYAN);
+				system("pause");
+			}
 		}
 		else if (choice == "3") {
 			output.println("Registration cancelled.", OutputManager::Color::YELLOW);
@@ -294,33 +375,28 @@ namespace EventBooking {
 	}
 
 	Registration EventBooking::completeRegistration(RegistrationStatus status) {
-		auto allRegistrations = dm.loadData<Registration>("registrations.json");
+		std::vector<Registration> customerRegistrations = dm.getRegistrationsForCustomer(user.userId);
 
-		Registration* target = nullptr;
+		Registration target;
 
-		auto it = std::find_if(allRegistrations.begin(), allRegistrations.end(),
+		auto it = std::find_if(customerRegistrations.begin(), customerRegistrations.end(),
 			[&](const Registration& reg) {
-				return reg.customerId == user.userId
-					&& reg.eventId == event.eventId
+				return reg.eventId == event.eventId
 					&& reg.registrationStatus != RegistrationStatus::PENDING;
 			});
 
-		if (it == allRegistrations.end() || status == RegistrationStatus::PENDING) {
-			Registration newReg;
-			newReg.registrationId = dm.generateNewRegistrationId();
-			newReg.customerId = user.userId;
-			newReg.eventId = event.eventId;
-			newReg.registerTime = time(nullptr);
-			newReg.registrationStatus = status;
-			newReg.seats.clear();
-			allRegistrations.push_back(newReg);
-			target = &allRegistrations.back();
+		if (it == customerRegistrations.end() || status == RegistrationStatus::PENDING) {
+			target.registrationId = dm.generateNewRegistrationId();
+			target.customerId = user.userId;
+			target.eventId = event.eventId;
+			target.registerTime = time(nullptr);
+			target.registrationStatus = status;
 		}
 		else {
-			it->registrationStatus = status;
-			target = &(*it);
-			target->seats.clear();
+			target = *it;
+			target.registrationStatus = status;
 		}
+		target.seats.clear();
 
 		for (const auto& seatId : selectedSeats) {
 			Seat s;
@@ -337,16 +413,26 @@ namespace EventBooking {
 				? SeatStatus::AVAILABLE
 				: SeatStatus::RESERVED;
 
-			s.registrationId = target->registrationId;
-			target->seats.push_back(s);
+			s.registrationId = target.registrationId;
+			target.seats.push_back(s);
 		}
 
-		dm.saveData(allRegistrations, "registrations.json");
+		std::vector<std::string> takenSeats;
+		if (!dm.reserveSeats(target, takenSeats)) {
+			std::string seatList;
+			for (const auto& seatId : takenSeats) {
+				seatList += (seatList.empty() ? "" : ", ") + seatId;
+			}
+			output.println("Sorry, these seats were just booked by someone else: " + seatList, OutputManager::Color::RED);
+			output.println("Please select your seats again.", OutputManager::Color::RED);
+			system("pause");
+			return Registration();
+		}
 
 		if (status == RegistrationStatus::PENDING) {
-			output.println("Registration ID: " + target->registrationId, OutputManager::Color::GREEN);
+			output.println("Registration ID: " + target.registrationId, OutputManager::Color::GREEN);
 		}
-		return *target;
+		return target;
 	}
 
 
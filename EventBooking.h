@@ -29,7 +29,9 @@ namespace EventBooking {
         void loadDataIntoVector(std::vector<std::vector<std::string>>& eventAttribute);
         void buyingTicket(int choice);
         bool getValidateInput(const std::string& prompt, std::string& result);
-        void printSeatMenu(const std::vector<std::string>& currentSelection);
+        void printSeatMenu(const std::vector<std::string>& currentSelection, size_t section);
+        bool selectSection(size_t& section);
+        bool autoSelectSeats();
         void selectSeats();
         Registration completeRegistration(RegistrationStatus status = RegistrationStatus::COMPLETED);
         void showPaymentOptions();
@@ -43,25 +43,18 @@ namespace EventCancellation {
 
 	void EventCancellation::updateEventStatus(const std::string& eventId) {
 		DataManager dm;
-		std::vector<Event> allEvents = dm.getAllActiveEvents();
-		std::vector<Registration> allRegistrations = dm.getAllActiveRegistrations();
-		std::vector<Payment> allPayment = dm.getAllActivePayments();
-		std::vector<Refund> allRefund = dm.getAllActiveRefunds();
-		
-		for (Registration& reg : allRegistrations) {
-			if (reg.eventId == eventId) {
-				reg.registrationStatus = RegistrationStatus::CANCELLED;
-			}
-		}
+		std::vector<Registration> eventRegistrations = dm.getRegistrationsForEvent(eventId);
+		std::vector<Payment> refundedPayments;
 
-		for (Event& event : allEvents) {
-			if (event.eventId == eventId) {
-				event.status = EventStatus::CANCELLED;
-			}
+		for (Registration& reg : eventRegistrations) {
+			reg.registrationStatus = RegistrationStatus::CANCELLED;
 		}
 
-		for (Payment& payment : allPayment) {
-			if (dm.getRegistrationFromRegistrationId(payment.registrationId).eventId == eventId) {
+		Event event = dm.getEventFromEventId(eventId);
+		event.status = EventStatus::CANCELLED;
+
+		for (const Registration& reg : eventRegistrations) {
+			for (Payment& payment : dm.getPaymentsForRegistration(reg.registrationId)) {
 				payment.paymentStatus = PaymentStatus::REFUNDED;
 				Refund refund;
 				refund.refundId = dm.generateNewRefundId();
@@ -69,14 +62,13 @@ namespace EventCancellation {
 				refund.refundAmount = payment.amount;
 				refund.refundDate = time(nullptr);
 				refund.reason = "Event Cancelled";
-				allRefund.push_back(refund);
+				dm.saveRecord(refund, dm.refundFileName);
+				refundedPayments.push_back(payment);
 			}
 		}
 				
-		dm.saveData(allRegistrations, "Registrations.json");
-		dm.saveData(allEvents, "Events.json");
-		dm.saveData(allPayment, "Payments.json");
-		dm.saveData(allRefund, "Refunds.json");
-		allRefund.clear();
+		dm.saveRecords(eventRegistrations, dm.registrationFileName);
+		dm.saveRecord(event, dm.eventFileName);
+		dm.saveRecords(refundedPayments, dm.paymentFileName);
 	}
 }
\ No newline at end of file
@@ -128,29 +128,42 @@ namespace EventMonitoring {
 		std::vector<std::vector<std::string>> attendanceData = dm.loadAttendanceMonitoring(event);
 		output.println("\n");
 		output.displayTable({"No.", "Attendance Id", "Customer", "Event", "Status", "Time", "Seats Id"}, attendanceData);
+		output.println("Unique attendees (est.): " + std::to_string(dm.getAudienceCounts().uniqueAttendees(event.eventId)));
 		system("pause");
 	}
 
 	void EventMonitoring::printAttendanceMenu() {
-		std::vector<std::vector<int>> venueAttendance(10, std::vector<int>(10, -1));
+		std::vector<std::vector<int>> venueAttendance;
 		dm.getAttendanceFromEvent(venueAttendance, event);
-		output.printAttendanceSeat(venueAttendance);
+
+		VenueLayout layout(event);
+		if (layout.sectionCount() <= 1) {
+			output.printAttendanceSeat(venueAttendance.empty() ? std::vector<std::vector<int>>(1) : venueAttendance);
+			return;
+		}
+		for (size_t i = 0; i < layout.sectionCount(); ++i) {
+			output.println("\nSection " + layout.section(i).name, OutputManager::Color::CYAN);
+			std::vector<std::vector<int>> sectionRows(venueAttendance.begin() + layout.firstRow(i) - 1,
+				venueAttendance.begin() + layout.lastRow(i));
+			output.printAttendanceSeat(sectionRows, layout.firstRow(i));
+		}
 	}
 
 	void EventMonitoring::displayAvailableSeat() {
 		output.clearScreen();
 		output.printHeader("Seat Availability Monitoring");
-		std::vector<std::vector<bool>> venueSeats(10, std::vector<bool>(10, false));
-
-		std::vector<Seat> occupied_seats = dm.getOccupiedSeatsForEvent(event.eventId);
-		for (const auto& seat : occupied_seats) {
-			int rowIndex = std::stoi(seat.row) - 1;
-			int colIndex = std::stoi(seat.column) - 1;
-			if (rowIndex >= 0 && rowIndex < 10 && colIndex >= 0 && colIndex < 10) {
-				venueSeats[rowIndex][colIndex] = true;
+		SeatMap seatMap = dm.getSeatMapForEvent(event.eventId);
+		const VenueLayout& layout = seatMap.layout();
+		if (layout.sectionCount() <= 1) {
+			output.printSeatingChart(seatMap.toGrid());
+		}
+		else {
+			output.displayTable({ "No.", "Section", "Rows", "Seats/Row", "Available" }, dm.loadSectionAvailability(event.eventId));
+			for (size_t i = 0; i < layout.sectionCount(); ++i) {
+				output.println("\nSection " + layout.section(i).name, OutputManager::Color::CYAN);
+				output.printSeatingChart(seatMap.toGrid(layout.firstRow(i), layout.lastRow(i)), layout.firstRow(i));
 			}
 		}
-		output.printSeatingChart(venueSeats);
 		output.println("\n");
 		std::vector<std::vector<std::string>> seatData = dm.loadSeatMonitoring(event);
 		output.displayTable({ "No.", "Seat Id", "Row", "Column", "Customer"}, seatData);
@@ -4,6 +4,7 @@
 #include "TimeUtils.h"
 #include "Model.h"
 #include "DataManager.h"
+#include "VenueLayout.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -32,11 +33,11 @@ namespace EventRegistration {
             displayMenu(event);
 
             if (isError) {
-                output.println("Invalid input! Please enter a number from 1 to 6.", OutputManager::Color::RED);
+                output.println("Invalid input! Please enter a number from 1 to 7.", OutputManager::Color::RED);
                 isError = false;
             }
 
-            output.print("Enter the index of the attribute to fill (1-6), 'c' to cancel, or 's' to save: ");
+            output.print("Enter the index of the attribute to fill (1-7), 'c' to cancel, or 's' to save: ");
             std::string userInput;
             std::getline(std::cin, userInput);
 
@@ -58,7 +59,7 @@ namespace EventRegistration {
                 continue;
             }
 
-            if (!validation.validateMenuInput(1, 6, userInput)) {
+            if (!validation.validateMenuInput(1, 7, userInput)) {
                 isError = true;
                 continue;
             }
@@ -78,7 +79,8 @@ namespace EventRegistration {
             "Event Date", event.eventDate == 0 ? "" : TimeManagement::formatTimeTToString(event.eventDate, "%Y-%m-%d"),
             "Start Time", event.startTime == 0 ? "" : TimeManagement::formatTimeTToString(event.startTime, "%H:%M"),
             "End Time", event.endTime == 0 ? "" : TimeManagement::formatTimeTToString(event.endTime, "%H:%M"),
-            "Ticket Price", event.ticketPrice == 0.0 ? "" : std::to_string(event.ticketPrice)
+            "Ticket Price", event.ticketPrice == 0.0 ? "" : std::to_string(event.ticketPrice),
+            "Venue Layout", VenueLayout::describe(VenueLayout(event).allSections()) + " (" + std::to_string(event.totalSeats) + " seats)"
         };
 
         system("cls");
@@ -106,6 +108,9 @@ namespace EventRegistration {
         case 6:
             editTicketPrice(event, validation, output);
             break;
+        case 7:
+            editVenueLayout(event, validation, output);
+            break;
         default:
             output.println("Invalid choice.", OutputManager::Color::RED);
             break;
@@ -272,6 +277,28 @@ namespace EventRegistration {
         } while (!validPriceEntered);
     }
 
+    void EventRegistration::editVenueLayout(Event& event, Validation& validation, OutputManager& output) {
+        std::string layoutStr;
+        bool validLayoutEntered = false;
+
+        do {
+            if (!getValidateInput("Enter sections as name:rows x seats, e.g. Floor:20x50, Balcony:10x30 ", layoutStr, validation, output)) {
+                return;
+            }
+
+            std::vector<VenueSection> sections;
+            if (VenueLayout::parse(layoutStr, sections)) {
+                event.sections = sections;
+                event.totalSeats = VenueLayout(sections).capacity();
+                validLayoutEntered = true;
+            }
+            else {
+                displayMenu(event);
+                output.println("Invalid layout. Each section needs a name and positive rows and seats per row.", OutputManager::Color::RED);
+            }
+        } while (!validLayoutEntered);
+    }
+
     bool EventRegistration::getValidateInput(const std::string& prompt, std::string& result, Validation& validation, OutputManager& output) {  
         output.print(prompt + "(press 'c' to cancel): ");
         std::string input;
@@ -295,9 +322,7 @@ namespace EventRegistration {
             return false;
         }
         DataManager dm;
-        std::vector<Event> allEvents = dm.getAllActiveEvents();
-        allEvents.push_back(event);
-        dm.saveData(allEvents, "events.json");
+        dm.saveRecord(event, dm.eventFileName);
         return true;
     }
 }
\ No newline at end of file
@@ -23,6 +23,7 @@ namespace EventRegistration {
         void editStartTime(Event& event, Validation& validation, OutputManager& output);
         void editEndTime(Event& event, Validation& validation, OutputManager& output);
         void editTicketPrice(Event& event, Validation& validation, OutputManager& output);
+        void editVenueLayout(Event& event, Validation& validation, OutputManager& output);
         bool getValidateInput(const std::string& prompt, std::string& result, Validation& validation, OutputManager& output);
         std::string generateNewEventId();
         bool saveEvent(const Event& event, Validation& validation);
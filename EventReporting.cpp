@@ -8,6 +8,9 @@
 #include <ctime>
 #include <map>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <string_view>
 #include <conio.h>
 #include <windows.h>
 #include "EventReporting.h"
@@ -134,35 +137,35 @@ void EventReporting::loadAllData() {
 }
 
 void EventReporting::loadPayments() {
-	payments = dm.getAllActivePayments();
+	payments = dm.viewData<Payment>(dm.paymentFileName);
 }
 
 void EventReporting::loadRegistrations() {
-	registrations = dm.getAllActiveRegistrations();
+	registrations = dm.viewData<Registration>(dm.registrationFileName);
 }
 
 void EventReporting::loadAttendances() {
-	attendances = dm.getAllActiveAttendances();
+	attendances = dm.viewData<Attendance>(dm.attendanceFileName);
 }
 
 void EventReporting::loadVotes() {
-	votes = dm.getAllActiveVotes();
+	votes = dm.viewData<Vote>(dm.voteFileName);
 }
 
 void EventReporting::loadUsers() {
-	users = dm.getAllActiveUsers();
+	users = dm.viewData<User>(dm.userFileName);
 }
 
 void EventReporting::loadEvents() {
-	events = dm.getAllActiveEvents();
+	events = dm.viewData<Event>(dm.eventFileName);
 }
 
 void EventReporting::loadPerformances() {
-	performances = dm.getAllActivePerformances();
+	performances = dm.viewData<Performance>(dm.performanceFileName);
 }
 
 void EventReporting::loadRefunds() {
-	refunds = dm.getAllActiveRefunds();
+	refunds = dm.viewData<Refund>(dm.refundFileName);
 }
 
 //--------------------------------Generate Report Function---------------------------------
@@ -200,27 +203,27 @@ void EventReporting::displayFinancialReportMenu() {
 			
 			// Create formatted amount string with dollar sign
 			ostringstream amountStr;
-			amountStr << "$" << fixed << setprecision(2) << payment.amount;
+			amountStr << "$" << fixed << setprecision(2) << payment.get(&Payment::amount);
 			
 			string method;
-			switch (payment.paymentMethod) {
+			switch (payment.get(&Payment::paymentMethod)) {
 			case PaymentMethod::CARD_PAYMENT: method = "CARD"; break;
 			case PaymentMethod::E_WALLET: method = "E-WALLET"; break;
 			case PaymentMethod::ONLINE_BANKING: method = "BANKING"; break;
 			}
 			
 			string status;
-			switch (payment.paymentStatus) {
+			switch (payment.get(&Payment::paymentStatus)) {
 			case PaymentStatus::COMPLETED: status = "COMPLETED"; break;
 			case PaymentStatus::PENDING: status = "PENDING"; break;
 			case PaymentStatus::FAILED: status = "FAILED"; break;
 			case PaymentStatus::REFUNDED: status = "REFUNDED"; break;
 			}
 			
-			row.push_back(payment.paymentId);
-			row.push_back(payment.registrationId);
+			row.push_back(std::string(payment.text(&Payment::paymentId)));
+			row.push_back(std::string(payment.text(&Payment::registrationId)));
 			row.push_back(amountStr.str());
-			row.push_back(timeToString(payment.paymentDate));
+			row.push_back(timeToString(payment.get(&Payment::paymentDate)));
 			row.push_back(method);
 			row.push_back(status);
 			
@@ -320,32 +323,33 @@ void EventReporting::generateFinancialSummary() {
 
 	// Calculate financial metrics from payments
 	for (const auto& payment : payments) {
-		switch (payment.paymentStatus) {
+		double amount = payment.get(&Payment::amount);
+		switch (payment.get(&Payment::paymentStatus)) {
 		case PaymentStatus::COMPLETED:
-			completedAmount += payment.amount;
+			completedAmount += amount;
 			completedCount++;
-			totalRevenue += payment.amount;
-			totalOriginalRevenue += payment.amount;
+			totalRevenue += amount;
+			totalOriginalRevenue += amount;
 			break;
 		case PaymentStatus::PENDING:
-			pendingAmount += payment.amount;
+			pendingAmount += amount;
 			pendingCount++;
 			break;
 		case PaymentStatus::FAILED:
-			failedAmount += payment.amount;
+			failedAmount += amount;
 			failedCount++;
 			break;
 		case PaymentStatus::REFUNDED:
-			refundedAmount += payment.amount;
+			refundedAmount += amount;
 			refundedCount++;
-			totalOriginalRevenue += payment.amount;
+			totalOriginalRevenue += amount;
 			break;
 		}
 	}
 
 	double totalRefundsPaidOut = 0.0;
 	for (const auto& refund : refunds) {
-		totalRefundsPaidOut += refund.refundAmount;
+		totalRefundsPaidOut += refund.get(&Refund::refundAmount);
 	}
 
 	double netRevenue = totalOriginalRevenue - totalRefundsPaidOut;
@@ -390,9 +394,10 @@ void EventReporting::generatePaymentMethodBreakdown() {
 
 	map<PaymentMethod, pair<int, double>> methodStats;
 	for (const auto& payment : payments) {
-		if (payment.paymentStatus == PaymentStatus::COMPLETED) {
-			methodStats[payment.paymentMethod].first++;
-			methodStats[payment.paymentMethod].second += payment.amount;
+		if (payment.get(&Payment::paymentStatus) == PaymentStatus::COMPLETED) {
+			PaymentMethod method = payment.get(&Payment::paymentMethod);
+			methodStats[method].first++;
+			methodStats[method].second += payment.get(&Payment::amount);
 		}
 	}
 
@@ -493,18 +498,18 @@ void EventReporting::displayAttendanceReportMenu() {
 		output.println("No registration data available.", OutputManager::Color::YELLOW);
 	}
 	else {
+		unordered_map<string_view, AttendanceStatus> attendanceOfRegistration = mapFirstAttendances();
+
 		for (const auto& registration : registrations) {
 			std::vector<std::string> row;
 			
 			AttendanceStatus status = AttendanceStatus::ABSENT;
 			bool hasAttendance = false;
 
-			for (const auto& attendance : attendances) {
-				if (attendance.registrationId == registration.registrationId) {
-					status = attendance.attendanceStatus;
-					hasAttendance = true;
-					break;
-				}
+			auto attendance = attendanceOfRegistration.find(registration.text(&Registration::registrationId));
+			if (attendance != attendanceOfRegistration.end()) {
+				status = attendance->second;
+				hasAttendance = true;
 			}
 
 			string attendanceStr;
@@ -520,12 +525,12 @@ void EventReporting::displayAttendanceReportMenu() {
 				attendanceStr = "NO RECORD";
 			}
 			
-			string regStatus = (registration.registrationStatus == RegistrationStatus::COMPLETED ? "COMPLETED" : "ONGOING");
+			string regStatus = (registration.get(&Registration::registrationStatus) == RegistrationStatus::COMPLETED ? "COMPLETED" : "ONGOING");
 			
-			row.push_back(registration.registrationId);
-			row.push_back(registration.customerId);
-			row.push_back(registration.eventId);
-			row.push_back(std::to_string(registration.seats.size()));
+			row.push_back(std::string(registration.text(&Registration::registrationId)));
+			row.push_back(std::string(registration.text(&Registration::customerId)));
+			row.push_back(std::string(registration.text(&Registration::eventId)));
+			row.push_back(std::to_string(registration.list(&Registration::seats).size()));
 			row.push_back(attendanceStr);
 			row.push_back(regStatus);
 			
@@ -614,25 +619,19 @@ void EventReporting::generateAttendanceSummary() {
 	int absentCount = 0;
 	int noRecordCount = 0;
 
-	for (const auto& registration : registrations) {
-		bool hasAttendance = false;
-
-		for (const auto& attendance : attendances) {
-			if (attendance.registrationId == registration.registrationId) {
-				if (attendance.attendanceStatus == AttendanceStatus::PRESENT) {
-					presentCount++;
-				}
-				else {
-					absentCount++;
-				}
-				hasAttendance = true;
-				break;
-			}
-		}
+	unordered_map<string_view, AttendanceStatus> attendanceOfRegistration = mapFirstAttendances();
 
-		if (!hasAttendance) {
+	for (const auto& registration : registrations) {
+		auto attendance = attendanceOfRegistration.find(registration.text(&Registration::registrationId));
+		if (attendance == attendanceOfRegistration.end()) {
 			noRecordCount++;
 		}
+		else if (attendance->second == AttendanceStatus::PRESENT) {
+			presentCount++;
+		}
+		else {
+			absentCount++;
+		}
 	}
 
 	cout << left << setw(25) << "Total Registrations: " << totalRegistrations << endl;
@@ -663,22 +662,30 @@ void EventReporting::generateEventWiseAttendance() {
 
 	map<string, tuple<int, int, string>> eventStats;
 
+	unordered_map<string_view, string_view> eventNames;
+	for (const auto& event : events) {
+		eventNames.emplace(event.text(&Event::eventId), event.text(&Event::eventName));
+	}
+
+	unordered_set<string_view> presentRegistrations;
+	for (const auto& attendance : attendances) {
+		if (attendance.get(&Attendance::attendanceStatus) == AttendanceStatus::PRESENT) {
+			presentRegistrations.insert(attendance.text(&Attendance::registrationId));
+		}
+	}
+
 	for (const auto& registration : registrations) {
-		get<0>(eventStats[registration.eventId])++;
+		string_view eventId = registration.text(&Registration::eventId);
+		tuple<int, int, string>& stats = eventStats[string(eventId)];
+		get<0>(stats)++;
 
-		for (const auto& event : events) {
-			if (event.eventId == registration.eventId) {
-				get<2>(eventStats[registration.eventId]) = event.eventName;
-				break;
-			}
+		auto eventName = eventNames.find(eventId);
+		if (eventName != eventNames.end()) {
+			get<2>(stats) = string(eventName->second);
 		}
 
-		for (const auto& attendance : attendances) {
-			if (attendance.registrationId == registration.registrationId &&
-				attendance.attendanceStatus == AttendanceStatus::PRESENT) {
-				get<1>(eventStats[registration.eventId])++;
-				break;
-			}
+		if (presentRegistrations.count(registration.text(&Registration::registrationId))) {
+			get<1>(stats)++;
 		}
 	}
 
@@ -747,10 +754,11 @@ void EventReporting::displayVotingReportMenu() {
 	map<string, string> songPerformers;
 
 	for (const auto& performance : performances) {
-		for (const auto& song : performance.songs) {
-			songVotes[song.songId] = 0;
-			songTitles[song.songId] = song.title;
-			songPerformers[song.songId] = performance.performerName;
+		for (const auto& song : performance.list(&Performance::songs)) {
+			string songId(song.text(&Song::songId));
+			songVotes[songId] = 0;
+			songTitles[songId] = string(song.text(&Song::title));
+			songPerformers[songId] = string(performance.text(&Performance::performerName));
 		}
 	}
 
@@ -759,9 +767,10 @@ void EventReporting::displayVotingReportMenu() {
 	map<string, int> voterCount;
 
 	for (const auto& vote : votes) {
-		songVotes[vote.songId] += vote.voteWeight;
-		totalVotes += vote.voteWeight;
-		voterCount[vote.registrationId] = 1;
+		int voteWeight = vote.get(&Vote::voteWeight);
+		songVotes[string(vote.text(&Vote::songId))] += voteWeight;
+		totalVotes += voteWeight;
+		voterCount[string(vote.text(&Vote::registrationId))] = 1;
 	}
 	totalVoters = static_cast<int>(voterCount.size());
 
@@ -892,10 +901,11 @@ void EventReporting::generateVotingSummary() {
 	map<string, string> songPerformers;
 
 	for (const auto& performance : performances) {
-		for (const auto& song : performance.songs) {
-			songVotes[song.songId] = 0;
-			songTitles[song.songId] = song.title;
-			songPerformers[song.songId] = performance.performerName;
+		for (const auto& song : performance.list(&Performance::songs)) {
+			string songId(song.text(&Song::songId));
+			songVotes[songId] = 0;
+			songTitles[songId] = string(song.text(&Song::title));
+			songPerformers[songId] = string(performance.text(&Performance::performerName));
 		}
 	}
 
@@ -904,9 +914,10 @@ void EventReporting::generateVotingSummary() {
 	map<string, int> voterCount;
 
 	for (const auto& vote : votes) {
-		songVotes[vote.songId] += vote.voteWeight;
-		totalVotes += vote.voteWeight;
-		voterCount[vote.registrationId] = 1;
+		int voteWeight = vote.get(&Vote::voteWeight);
+		songVotes[string(vote.text(&Vote::songId))] += voteWeight;
+		totalVotes += voteWeight;
+		voterCount[string(vote.text(&Vote::registrationId))] = 1;
 	}
 	totalVoters = static_cast<int>(voterCount.size());
 
@@ -949,34 +960,36 @@ void EventReporting::generatePerformanceWiseVoting() {
 	map<string, string> songTitles = loadSongTitles();
 
 	for (const auto& performance : performances) {
-		for (const auto& song : performance.songs) {
-			songVotes[song.songId] = 0;
-			songTitles[song.songId] = song.title;
+		for (const auto& song : performance.list(&Performance::songs)) {
+			string songId(song.text(&Song::songId));
+			songVotes[songId] = 0;
+			songTitles[songId] = string(song.text(&Song::title));
 		}
 	}
 
 	int totalVotes = 0;
 	for (const auto& vote : votes) {
-		songVotes[vote.songId] += vote.voteWeight;
-		totalVotes += vote.voteWeight;
+		int voteWeight = vote.get(&Vote::voteWeight);
+		songVotes[string(vote.text(&Vote::songId))] += voteWeight;
+		totalVotes += voteWeight;
 	}
 
 	for (const auto& performance : performances) {
-		cout << "\nPerformance: " << performance.performerName
-			<< " (ID: " << performance.performanceId << ")" << endl;
-		cout << "Event:  " << performance.eventId << endl;
+		cout << "\nPerformance: " << performance.text(&Performance::performerName)
+			<< " (ID: " << performance.text(&Performance::performanceId) << ")" << endl;
+		cout << "Event:  " << performance.text(&Performance::eventId) << endl;
 
 		int perfTotalVotes = 0;
 		bool hasVotes = false;
 
-		for (const auto& song : performance.songs) {
-			int songVoteCount = songVotes[song.songId];
+		for (const auto& song : performance.list(&Performance::songs)) {
+			int songVoteCount = songVotes[string(song.text(&Song::songId))];
 			perfTotalVotes += songVoteCount;
 
 			if (songVoteCount > 0) {
 				hasVotes = true;
 				double songPercentage = totalVotes > 0 ? (double)songVoteCount / totalVotes * 100 : 0;
-				cout << " " << song.title << ": " << songVoteCount
+				cout << " " << song.text(&Song::title) << ": " << songVoteCount
 					<< " votes (" << fixed << setprecision(1) << songPercentage << "%)" << endl;
 			}
 		}
@@ -1025,6 +1038,14 @@ string EventReporting::getPaymentStatusString(PaymentStatus status) {
 	}
 }
 
+unordered_map<string_view, AttendanceStatus> EventReporting::mapFirstAttendances() {
+	unordered_map<string_view, AttendanceStatus> attendanceOfRegistration;
+	for (const auto& attendance : attendances) {
+		attendanceOfRegistration.emplace(attendance.text(&Attendance::registrationId), attendance.get(&Attendance::attendanceStatus));
+	}
+	return attendanceOfRegistration;
+}
+
 map<string, string> EventReporting::loadSongTitles() {
 	map<string, string> songTitles;
 
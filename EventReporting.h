@@ -3,6 +3,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <string_view>
 #include <algorithm>
 #include <iomanip>
 #include <fstream>
@@ -18,14 +20,14 @@ public:
 
 private: 
 	DataManager dm;
-	std::vector<Payment> payments;
-	std::vector<Registration> registrations;
-	std::vector<Attendance> attendances;
-	std::vector<Vote> votes;
-	std::vector<User> users;
-	std::vector<Event> events;
-	std::vector<Performance> performances;
-	std::vector<Refund> refunds;
+	SnapshotView<Payment> payments;
+	SnapshotView<Registration> registrations;
+	SnapshotView<Attendance> attendances;
+	SnapshotView<Vote> votes;
+	SnapshotView<User> users;
+	SnapshotView<Event> events;
+	SnapshotView<Performance> performances;
+	SnapshotView<Refund> refunds;
 
 	void loadAllData();
 	void displayReportMenu();
@@ -63,6 +65,7 @@ private:
 	void printSeparator(int width = 80);
 	std::string getPaymentStatusString(PaymentStatus status);
 	std::map<std::string, std::string> loadSongTitles();
+	std::unordered_map<std::string_view, AttendanceStatus> mapFirstAttendances();
 	void printMiddle(int line_width, std::string title);
 
 	// Data loading functions
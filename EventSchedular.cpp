@@ -19,16 +19,14 @@
 
 using json = nlohmann::json;
 
-EventSchedular::EventSchedular() : performanceCounter(0), globalSongCounter(0) {
+EventSchedular::EventSchedular() {
 	loadEvents();
 	loadPerformances();
-	loadGlobalSongCounter();
 }
 
-EventSchedular::EventSchedular(const User& user) : performanceCounter(0), globalSongCounter(0), currentUser(user) {
+EventSchedular::EventSchedular(const User& user) : currentUser(user) {
 	loadEvents();
 	loadPerformances();
-	loadGlobalSongCounter();
 }
 
 void EventSchedular::run() {
@@ -564,8 +562,7 @@ void EventSchedular::deletePerformance() {
 //=================================================================================
 
 std::string EventSchedular::generatePerformanceId() {
-	performanceCounter++;
-	return "PERF" + std::to_string(1000 + performanceCounter).substr(1);
+	return dm.generateNewPerformanceId();
 }
 
 time_t EventSchedular::getValidatedTimeInputWithESC(const std::string& prompt, const Event& event, bool& wasCancelled) {
@@ -621,15 +618,7 @@ void EventSchedular::loadPerformances() {
 }
 
 void EventSchedular::savePerformancesToFile() {
-	json j = json::array();
-
-	for (const auto& performance : performances) {
-		j.push_back(performance);
-	}
-
-	std::ofstream file("performances.json");
-	file << j.dump(4);
-	file.close();
+	dm.saveData(performances, dm.performanceFileName);
 }
 
 std::string EventSchedular::timeToString(time_t timeValue) {
@@ -1152,24 +1141,8 @@ bool EventSchedular::addSongToPerformanceWithESC(Performance& performance) {
 
 //---------------------------------------------------------------------------------
 
-void EventSchedular::loadGlobalSongCounter() {
-	std::ifstream file("global_song_counter.txt");
-	if (file.is_open()) {
-		file >> globalSongCounter;
-		file.close();
-	}
-}
-
-void EventSchedular::saveGlobalSongCounter() {
-	std::ofstream file("global_song_counter.txt");
-	file << globalSongCounter;
-	file.close();
-}
-
 std::string EventSchedular::generateSongId() {
-	globalSongCounter++;
-	saveGlobalSongCounter();
-	return "SONG" + std::to_string(10000 + globalSongCounter).substr(1);
+	return dm.generateNewSongId();
 }
 
 void EventSchedular::saveSongToFile(const std::string& songId, const std::string& title, const std::string& performerName) {
@@ -18,8 +18,6 @@ private:
 	std::vector<Performance> performances;
 	std::vector<Event> events;
 	std::string selectedEventId;
-	int performanceCounter;
-	int globalSongCounter;
 
 	void displayMenu();
     void managePerformancesForEvent();
@@ -70,8 +68,6 @@ private:
     void displayPerformanceForEvent();
 
     // Song management
-    void loadGlobalSongCounter();
-    void saveGlobalSongCounter();
     std::string generateSongId();
     void saveSongToFile(const std::string& songId, const std::string& title, const std::string& performerName);
     void deleteSongsFromFile(const std::vector<Song>& songs);
@@ -0,0 +1,351 @@
+#include "FileUtils.h"
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#include <io.h>
+#include <process.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FileManagement {
+
+    bool readFile(const std::string& path, std::string& contents) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        contents = buffer.str();
+        return true;
+    }
+
+    static bool flushToDisk(FILE* file) {
+        if (std::fflush(file) != 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+#ifndef _WIN32
+    // A rename or a newly created file is an entry in its directory, which is
+    // only durable once the directory itself has been flushed.
+    static bool flushDirectoryOf(const std::string& path) {
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        if (directory.empty()) {
+            directory = ".";
+        }
+        int descriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (descriptor < 0) {
+            return false;
+        }
+        bool flushed = fsync(descriptor) == 0;
+        return close(descriptor) == 0 && flushed;
+    }
+#endif
+
+    static bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0 && flushDirectoryOf(to);
+#endif
+    }
+
+    // Temporary files are named per process and per write, so concurrent
+    // writers of the same target never share one.
+    static std::string tempFileName(const std::string& path) {
+        static std::atomic<unsigned long long> sequence{ 0 };
+#ifdef _WIN32
+        long long processId = _getpid();
+#else
+        long long processId = getpid();
+#endif
+        return path + "." + std::to_string(processId) + "-" + std::to_string(++sequence) + ".tmp";
+    }
+
+    // Writes to a temporary file, forces it to disk and renames it over the
+    // target, so readers only ever see the old file or the complete new one.
+    bool writeFileAtomically(const std::string& path, const std::string& contents) {
+        std::string tempPath = tempFileName(path);
+        FILE* file = std::fopen(tempPath.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+
+        bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+        written = flushToDisk(file) && written;
+        written = std::fclose(file) == 0 && written;
+
+        if (!written || !replaceFile(tempPath, path)) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool appendFileDurably(const std::string& path, const std::string& contents) {
+#ifndef _WIN32
+        std::error_code existsError;
+        bool created = !std::filesystem::exists(path, existsError);
+#endif
+        uint64_t oldLength = fileSize(path);
+        FILE* file = std::fopen(path.c_str(), "ab");
+        if (!file) {
+            return false;
+        }
+
+        bool written = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+        written = flushToDisk(file) && written;
+        written = std::fclose(file) == 0 && written;
+
+        if (!written) {
+            std::error_code error;
+            std::filesystem::resize_file(path, oldLength, error);
+            return false;
+        }
+#ifndef _WIN32
+        if (created) {
+            return flushDirectoryOf(path);
+        }
+#endif
+        return true;
+    }
+
+    static std::array<uint32_t, 256> makeChecksumTable() {
+        std::array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    // CRC-32 (IEEE 802.3).
+    uint32_t checksum(std::string_view data) {
+        static const std::array<uint32_t, 256> table = makeChecksumTable();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (unsigned char c : data) {
+            crc = table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    static std::string checksumFileName(const std::string& path) {
+        return path + ".crc";
+    }
+
+    // The checksum manifest is replaced before the file and keeps the checksum
+    // of the file being replaced, so a crash between the two renames still
+    // leaves a file that verifies.
+    bool writeFileWithChecksum(const std::string& path, const std::string& contents) {
+        std::ostringstream manifest;
+        manifest << std::hex << checksum(contents);
+        std::string previous;
+        if (readFile(path, previous)) {
+            manifest << ' ' << checksum(previous);
+        }
+        manifest << '\n';
+
+        return writeFileAtomically(checksumFileName(path), manifest.str()) &&
+            writeFileAtomically(path, contents);
+    }
+
+    // Files without a manifest are accepted as written by hand.
+    bool verifyChecksum(const std::string& path, std::string_view contents) {
+        std::string manifest;
+        if (!readFile(checksumFileName(path), manifest)) {
+            return true;
+        }
+        uint32_t actual = checksum(contents);
+        std::istringstream checksums(manifest);
+        uint32_t expected;
+        while (checksums >> std::hex >> expected) {
+            if (expected == actual) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void removeFileWithChecksum(const std::string& path) {
+        std::remove(path.c_str());
+        std::remove(checksumFileName(path).c_str());
+    }
+
+    uint64_t fileSize(const std::string& path) {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        return error ? 0 : static_cast<uint64_t>(size);
+    }
+
+    std::string fileStamp(const std::string& path) {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        if (error) {
+            return "";
+        }
+        auto modified = std::filesystem::last_write_time(path, error);
+        if (error) {
+            return "";
+        }
+        return std::to_string(size) + ":" + std::to_string(modified.time_since_epoch().count());
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            return false;
+        }
+        fileHandle = file;
+        length = static_cast<size_t>(size.QuadPart);
+        if (length == 0) {
+            return true;
+        }
+        mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle) {
+            data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(file, &info) != 0) {
+            ::close(file);
+            return false;
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length == 0) {
+            ::close(file);
+            return true;
+        }
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char*>(mapping);
+        }
+#endif
+        if (!data) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::close() {
+#ifdef _WIN32
+        if (data) {
+            UnmapViewOfFile(data);
+        }
+        if (mappingHandle) {
+            CloseHandle(mappingHandle);
+        }
+        if (fileHandle) {
+            CloseHandle(fileHandle);
+        }
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+#else
+        if (data) {
+            munmap(const_cast<char*>(data), length);
+        }
+#endif
+        data = nullptr;
+        length = 0;
+    }
+
+    std::string_view MappedFile::contents() const {
+        return data ? std::string_view(data, length) : std::string_view();
+    }
+
+    FileLock::~FileLock() {
+        unlock();
+    }
+
+    bool FileLock::lock(const std::string& path) {
+        return acquire(path, true);
+    }
+
+    bool FileLock::tryLock(const std::string& path) {
+        return acquire(path, false);
+    }
+
+    bool FileLock::acquire(const std::string& path, bool wait) {
+        unlock();
+#ifdef _WIN32
+        HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        OVERLAPPED whole = {};
+        DWORD flags = LOCKFILE_EXCLUSIVE_LOCK | (wait ? 0 : LOCKFILE_FAIL_IMMEDIATELY);
+        if (!LockFileEx(handle, flags, 0, MAXDWORD, MAXDWORD, &whole)) {
+            CloseHandle(handle);
+            return false;
+        }
+        fileHandle = handle;
+#else
+        int handle = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (handle < 0) {
+            return false;
+        }
+        int result;
+        do {
+            result = flock(handle, wait ? LOCK_EX : LOCK_EX | LOCK_NB);
+        } while (result != 0 && wait && errno == EINTR);
+        if (result != 0) {
+            ::close(handle);
+            return false;
+        }
+        file = handle;
+#endif
+        return true;
+    }
+
+    void FileLock::unlock() {
+#ifdef _WIN32
+        if (fileHandle) {
+            CloseHandle(fileHandle);
+        }
+        fileHandle = nullptr;
+#else
+        if (file >= 0) {
+            ::close(file);
+        }
+        file = -1;
+#endif
+    }
+}
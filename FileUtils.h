@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace FileManagement {
+    bool readFile(const std::string& path, std::string& contents);
+    bool writeFileAtomically(const std::string& path, const std::string& contents);
+    // Appends contents and forces them to disk. On failure the file is cut
+    // back to its old length, so no partial write is left behind.
+    bool appendFileDurably(const std::string& path, const std::string& contents);
+    uint32_t checksum(std::string_view data);
+    bool writeFileWithChecksum(const std::string& path, const std::string& contents);
+    bool verifyChecksum(const std::string& path, std::string_view contents);
+    void removeFileWithChecksum(const std::string& path);
+    // Size of the file in bytes, or 0 when it does not exist.
+    uint64_t fileSize(const std::string& path);
+    // Size and modification time of the file, or "" when it does not exist.
+    // Changes whenever the file is rewritten.
+    std::string fileStamp(const std::string& path);
+
+    // Read-only memory mapping of a whole file.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path);
+        void close();
+        std::string_view contents() const;
+
+    private:
+        const char* data = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+
+    // Exclusive lock on a file for the lifetime of the object. The operating
+    // system drops it when the process exits, even on a crash.
+    class FileLock {
+    public:
+        FileLock() = default;
+        ~FileLock();
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+        // Waits until the lock is free; false only when the file cannot be opened.
+        bool lock(const std::string& path);
+        bool tryLock(const std::string& path);
+        void unlock();
+
+    private:
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+#else
+        int file = -1;
+#endif
+
+        bool acquire(const std::string& path, bool wait);
+    };
+}
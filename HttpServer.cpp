@@ -0,0 +1,545 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#include "HttpServer.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+    const NativeSocket NO_SOCKET = INVALID_SOCKET;
+    int pollSockets(pollfd* fds, size_t count, int timeoutMs) { return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs); }
+    void closeSocket(NativeSocket s) { closesocket(s); }
+    bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+    void setNonBlocking(NativeSocket s) {
+        u_long mode = 1;
+        ioctlsocket(s, FIONBIO, &mode);
+    }
+    const int SEND_FLAGS = 0;
+
+    // Windows cannot poll a pipe, so the wakeup is a UDP socket connected to
+    // itself.
+    bool openWakeup(NativeSocket& readEnd, NativeSocket& writeEnd) {
+        NativeSocket s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (s == NO_SOCKET) {
+            return false;
+        }
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int length = sizeof(address);
+        if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) != 0
+            || connect(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            closesocket(s);
+            return false;
+        }
+        setNonBlocking(s);
+        readEnd = writeEnd = s;
+        return true;
+    }
+    void closeWakeup(NativeSocket readEnd, NativeSocket) { closesocket(readEnd); }
+    void sendWakeup(NativeSocket s) {
+        char byte = 1;
+        send(s, &byte, 1, 0);
+    }
+    int receiveWakeup(NativeSocket s, char* buffer, int size) { return recv(s, buffer, size, 0); }
+#else
+    using NativeSocket = int;
+    const NativeSocket NO_SOCKET = -1;
+    int pollSockets(pollfd* fds, size_t count, int timeoutMs) { return poll(fds, static_cast<nfds_t>(count), timeoutMs); }
+    void closeSocket(NativeSocket s) { close(s); }
+    bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+    void setNonBlocking(NativeSocket s) { fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK); }
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+
+    bool openWakeup(NativeSocket& readEnd, NativeSocket& writeEnd) {
+        int ends[2];
+        if (pipe(ends) != 0) {
+            return false;
+        }
+        readEnd = ends[0];
+        writeEnd = ends[1];
+        setNonBlocking(readEnd);
+        setNonBlocking(writeEnd);
+        return true;
+    }
+    void closeWakeup(NativeSocket readEnd, NativeSocket writeEnd) {
+        close(readEnd);
+        close(writeEnd);
+    }
+    void sendWakeup(NativeSocket s) {
+        char byte = 1;
+        // A full pipe already wakes the loop.
+        if (write(s, &byte, 1) < 0) {
+        }
+    }
+    int receiveWakeup(NativeSocket s, char* buffer, int size) { return static_cast<int>(read(s, buffer, static_cast<size_t>(size))); }
+#endif
+
+    NativeSocket native(std::uintptr_t handle) { return static_cast<NativeSocket>(handle); }
+
+    std::string lowerCase(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Undoes %XX escapes; false when one is malformed.
+    bool percentDecode(const std::string& text, std::string& decoded) {
+        decoded.clear();
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] != '%') {
+                decoded += text[i];
+                continue;
+            }
+            int high = i + 2 < text.size() ? hexValue(text[i + 1]) : -1;
+            int low = i + 2 < text.size() ? hexValue(text[i + 2]) : -1;
+            if (high < 0 || low < 0) {
+                return false;
+            }
+            decoded += static_cast<char>(high * 16 + low);
+            i += 2;
+        }
+        return true;
+    }
+
+    // Malformed fields fall back to the exclusive shard; handle() then
+    // reports them.
+    std::string shardKeyOf(RequestEngine& engine, const nlohmann::json& request) {
+        try {
+            return engine.shardKey(request);
+        }
+        catch (const std::exception&) {
+            return "";
+        }
+    }
+
+    const char* statusText(int status) {
+        switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        default: return "Internal Server Error";
+        }
+    }
+
+}
+
+struct HttpServer::Wakeup {
+    NativeSocket readEnd = NO_SOCKET;
+    NativeSocket writeEnd = NO_SOCKET;
+    std::atomic<bool> signalled{ false };
+
+    Wakeup() {
+        if (!openWakeup(readEnd, writeEnd)) {
+            throw std::runtime_error("Unable to create the server wakeup pipe.");
+        }
+    }
+    ~Wakeup() { closeWakeup(readEnd, writeEnd); }
+
+    // Called by workers once a reply is ready; one byte per poll is enough.
+    void signal() {
+        if (!signalled.exchange(true)) {
+            sendWakeup(writeEnd);
+        }
+    }
+    void drain() {
+        signalled = false;
+        char buffer[64];
+        while (receiveWakeup(readEnd, buffer, sizeof(buffer)) > 0) {
+        }
+    }
+};
+
+HttpServer::HttpServer(RequestEngine& engine, ShardedExecutor& executor)
+    : engine(engine), executor(executor), listener(static_cast<SocketHandle>(NO_SOCKET)) {
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        throw std::runtime_error("Unable to start Winsock.");
+    }
+#endif
+    wakeup = std::make_shared<Wakeup>();
+}
+
+HttpServer::~HttpServer() {
+    for (auto& connection : connections) {
+        closeSocket(native(connection->socket));
+    }
+    if (native(listener) != NO_SOCKET) {
+        closeSocket(native(listener));
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void HttpServer::listen(unsigned short port) {
+    NativeSocket s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == NO_SOCKET) {
+        throw std::runtime_error("Unable to create the server socket.");
+    }
+    int reuse = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(s, SOMAXCONN) != 0) {
+        closeSocket(s);
+        throw std::runtime_error("Unable to listen on 127.0.0.1:" + std::to_string(port) + ".");
+    }
+    setNonBlocking(s);
+    listener = static_cast<SocketHandle>(s);
+}
+
+void HttpServer::run() {
+    running = true;
+    std::vector<pollfd> fds;
+
+    while (running) {
+        fds.clear();
+        fds.push_back({ native(listener), POLLIN, 0 });
+        fds.push_back({ wakeup->readEnd, POLLIN, 0 });
+        for (auto& connection : connections) {
+            short events = 0;
+            if (!connection->closing && connection->input.size() < connection->inputLimit) events |= POLLIN;
+            if (!connection->output.empty()) events |= POLLOUT;
+            fds.push_back({ native(connection->socket), events, 0 });
+        }
+
+        // Workers wake poll when a reply is ready; the timeout only bounds
+        // how long stop() takes.
+        if (pollSockets(fds.data(), fds.size(), 100) < 0 && !wouldBlock()) {
+            throw std::runtime_error("Polling the server sockets failed.");
+        }
+        if (fds[1].revents & POLLIN) {
+            wakeup->drain();
+        }
+
+        for (size_t i = 0; i < connections.size(); ++i) {
+            Connection& connection = *connections[i];
+            short revents = fds[i + 2].revents;
+            if (revents & (POLLIN | POLLHUP | POLLERR)) {
+                readFrom(connection);
+            }
+            // Collecting first lets a request held back for an earlier
+            // booking go out in this pass; collecting again picks up the
+            // replies dispatch answered at once.
+            collectReplies(connection);
+            dispatchRequests(connection);
+            collectReplies(connection);
+            if (!connection.output.empty()) {
+                writeTo(connection);
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            acceptConnections();
+        }
+
+        connections.erase(std::remove_if(connections.begin(), connections.end(), [](const std::unique_ptr<Connection>& connection) {
+            bool finished = connection->broken
+                || (connection->closing && connection->pending.empty() && connection->output.empty());
+            if (finished) {
+                closeSocket(native(connection->socket));
+            }
+            return finished;
+        }), connections.end());
+    }
+}
+
+void HttpServer::acceptConnections() {
+    for (;;) {
+        NativeSocket s = accept(native(listener), nullptr, nullptr);
+        if (s == NO_SOCKET) {
+            return;
+        }
+        setNonBlocking(s);
+        int noDelay = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+        auto connection = std::make_unique<Connection>();
+        connection->socket = static_cast<SocketHandle>(s);
+        connections.push_back(std::move(connection));
+    }
+}
+
+void HttpServer::readFrom(Connection& connection) {
+    char buffer[16384];
+    while (connection.input.size() < connection.inputLimit) {
+        int received = recv(native(connection.socket), buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received == 0) {
+            // The client finished sending; answer what it already asked.
+            connection.closing = true;
+        }
+        else if (!wouldBlock()) {
+            connection.broken = true;
+        }
+        return;
+    }
+}
+
+void HttpServer::dispatchRequests(Connection& connection) {
+    while (!connection.input.empty()) {
+        Request request;
+        size_t used = 0;
+        try {
+            used = parseRequest(connection.input, request, connection.inputLimit);
+        }
+        catch (const std::length_error& e) {
+            rejectRequest(connection, 413, e.what());
+            return;
+        }
+        catch (const std::invalid_argument& e) {
+            rejectRequest(connection, 400, e.what());
+            return;
+        }
+        if (used == 0) {
+            return;
+        }
+
+        nlohmann::json engineRequest;
+        int routeStatus = routeRequest(request, engineRequest);
+        if (routeStatus != 0) {
+            std::string message = routeStatus == 400 ? "Malformed escape in " + request.path + "."
+                : "No route for " + request.method + " " + request.path + ".";
+            nlohmann::json error = { {"ok", false}, {"error", message} };
+            connection.pending.push_back({ readyReply(response(routeStatus, error.dump(), request.keepAlive)), request.keepAlive });
+        }
+        else {
+            // A registration still being created by an earlier pipelined
+            // booking cannot be looked up yet; wait for that reply first.
+            if (RequestEngine::keyedByRegistration(engineRequest)
+                && std::any_of(connection.pending.begin(), connection.pending.end(), [](const PendingReply& reply) { return reply.booking; })) {
+                return;
+            }
+            submitRequest(connection, engineRequest, request.keepAlive);
+        }
+
+        connection.input.erase(0, used);
+        connection.inputLimit = MAX_HEADER_BYTES;
+        if (!request.keepAlive) {
+            connection.input.clear();
+            connection.closing = true;
+            return;
+        }
+    }
+}
+
+void HttpServer::submitRequest(Connection& connection, const nlohmann::json& engineRequest, bool keepAlive) {
+    auto reply = std::make_shared<std::promise<std::string>>();
+    bool booking = engineRequest.is_object() && engineRequest.value("op", "") == "book";
+    connection.pending.push_back({ reply->get_future(), keepAlive, booking });
+
+    RequestEngine& handler = engine;
+    std::shared_ptr<Wakeup> wake = wakeup;
+    auto run = [&handler, engineRequest, keepAlive, reply, wake] {
+        try {
+            nlohmann::json result = handler.handle(engineRequest);
+            reply->set_value(response(result.value("ok", false) ? 200 : 400, result.dump(), keepAlive));
+        }
+        catch (...) {
+            reply->set_exception(std::current_exception());
+        }
+        wake->signal();
+    };
+    if (!RequestEngine::keyedByRegistration(engineRequest)) {
+        executor.submit(shardKeyOf(engine, engineRequest), run);
+        return;
+    }
+
+    // Finding the registration's event takes the store lock, so a worker
+    // picked by registration id looks it up and passes the request on.
+    ShardedExecutor& workers = executor;
+    executor.submit(engineRequest["registrationId"].get<std::string>(), [&handler, &workers, engineRequest, run] {
+        workers.submit(shardKeyOf(handler, engineRequest), run);
+    });
+}
+
+void HttpServer::rejectRequest(Connection& connection, int status, const std::string& message) {
+    nlohmann::json error = { {"ok", false}, {"error", message} };
+    connection.pending.push_back({ readyReply(response(status, error.dump(), false)), false });
+    connection.input.clear();
+    connection.closing = true;
+}
+
+void HttpServer::collectReplies(Connection& connection) {
+    while (!connection.pending.empty()
+        && connection.pending.front().reply.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        connection.output += connection.pending.front().reply.get();
+        connection.pending.pop_front();
+    }
+}
+
+void HttpServer::writeTo(Connection& connection) {
+    while (!connection.output.empty()) {
+        int sent = send(native(connection.socket), connection.output.data(),
+            static_cast<int>(std::min<size_t>(connection.output.size(), 1 << 20)), SEND_FLAGS);
+        if (sent > 0) {
+            connection.output.erase(0, static_cast<size_t>(sent));
+            continue;
+        }
+        if (sent < 0 && !wouldBlock()) {
+            connection.broken = true;
+        }
+        return;
+    }
+}
+
+size_t HttpServer::parseRequest(const std::string& buffer, Request& request, size_t& needed) {
+    needed = MAX_HEADER_BYTES;
+    size_t headerEnd = buffer.find("\r\n\r\n");
+    if (headerEnd == std::string::npos ? buffer.size() >= MAX_HEADER_BYTES : headerEnd + 4 > MAX_HEADER_BYTES) {
+        throw std::length_error("Request headers are too large.");
+    }
+    if (headerEnd == std::string::npos) {
+        return 0;
+    }
+
+    size_t lineEnd = buffer.find("\r\n");
+    std::string requestLine = buffer.substr(0, lineEnd);
+    size_t methodEnd = requestLine.find(' ');
+    size_t pathEnd = requestLine.find(' ', methodEnd == std::string::npos ? 0 : methodEnd + 1);
+    if (methodEnd == std::string::npos || pathEnd == std::string::npos) {
+        throw std::invalid_argument("Malformed request line.");
+    }
+    request.method = requestLine.substr(0, methodEnd);
+    request.path = requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+    std::string version = requestLine.substr(pathEnd + 1);
+    if (version.compare(0, 5, "HTTP/") != 0) {
+        throw std::invalid_argument("Malformed request line.");
+    }
+    request.keepAlive = version != "HTTP/1.0";
+
+    size_t contentLength = 0;
+    size_t position = lineEnd + 2;
+    while (position < headerEnd) {
+        size_t end = buffer.find("\r\n", position);
+        std::string header = buffer.substr(position, end - position);
+        position = end + 2;
+
+        size_t colon = header.find(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("Malformed header.");
+        }
+        std::string name = lowerCase(header.substr(0, colon));
+        std::string value = header.substr(header.find_first_not_of(' ', colon + 1) == std::string::npos
+            ? header.size() : header.find_first_not_of(' ', colon + 1));
+
+        if (name == "content-length") {
+            try {
+                contentLength = std::stoul(value);
+            }
+            catch (const std::exception&) {
+                throw std::invalid_argument("Malformed Content-Length.");
+            }
+        }
+        else if (name == "connection") {
+            std::string option = lowerCase(value);
+            if (option == "close") request.keepAlive = false;
+            else if (option == "keep-alive") request.keepAlive = true;
+        }
+        else if (name == "transfer-encoding") {
+            throw std::invalid_argument("Chunked bodies are not supported; send Content-Length.");
+        }
+    }
+
+    size_t bodyStart = headerEnd + 4;
+    if (contentLength > MAX_BODY_BYTES) {
+        throw std::length_error("Request body is too large.");
+    }
+    needed = bodyStart + contentLength;
+    if (buffer.size() < needed) {
+        return 0;
+    }
+    request.body = buffer.substr(bodyStart, contentLength);
+    return bodyStart + contentLength;
+}
+
+int HttpServer::routeRequest(const Request& request, nlohmann::json& engineRequest) {
+    std::string path = request.path.substr(0, request.path.find('?'));
+
+    static const std::pair<const char*, const char*> postRoutes[] = {
+        {"/bookings", "book"}, {"/payments", "pay"}, {"/votes", "vote"},
+        {"/checkins", "checkin"}, {"/cancellations", "cancel"}
+    };
+    for (const auto& route : postRoutes) {
+        if (path == route.first) {
+            if (request.method != "POST") {
+                return 405;
+            }
+            engineRequest = nlohmann::json::parse(request.body.empty() ? "{}" : request.body, nullptr, false);
+            if (engineRequest.is_discarded() || !engineRequest.is_object()) {
+                // Let the engine answer with its usual error reply.
+                engineRequest = nlohmann::json::array();
+                return 0;
+            }
+            engineRequest["op"] = route.second;
+            return 0;
+        }
+    }
+
+    // /events/{id}/availability, /events/{id}/sales, /events/{id}/votes,
+    // /events/{id}/trending, /events/{id}/audience
+    const std::string prefix = "/events/";
+    size_t slash = path.find('/', prefix.size());
+    if (path.compare(0, prefix.size(), prefix) == 0 && slash != std::string::npos) {
+        std::string report = path.substr(slash + 1);
+        if (report == "availability" || report == "sales" || report == "votes" || report == "trending"
+            || report == "audience") {
+            if (request.method != "GET") {
+                return 405;
+            }
+            std::string eventId;
+            if (!percentDecode(path.substr(prefix.size(), slash - prefix.size()), eventId)) {
+                return 400;
+            }
+            engineRequest = { {"op", report}, {"eventId", eventId} };
+            return 0;
+        }
+    }
+    return 404;
+}
+
+std::string HttpServer::response(int status, const std::string& body, bool keepAlive) {
+    std::string reply = "HTTP/1.1 " + std::to_string(status) + " " + statusText(status) + "\r\n";
+    reply += "Content-Type: application/json\r\n";
+    reply += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    reply += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    return reply + body;
+}
+
+std::future<std::string> HttpServer::readyReply(const std::string& reply) {
+    std::promise<std::string> promise;
+    promise.set_value(reply);
+    return promise.get_future();
+}
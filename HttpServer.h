@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "RequestEngine.h"
+#include "ShardedExecutor.h"
+
+// Serves RequestEngine as JSON over HTTP/1.1 on the loopback interface.
+//
+//   POST /bookings                    body as the "book" request
+//   POST /payments                    body as the "pay" request
+//   POST /votes                       body as the "vote" request
+//   POST /checkins                    body as the "checkin" request
+//   POST /cancellations               body as the "cancel" request
+//   GET  /events/{id}/availability
+//   GET  /events/{id}/sales
+//   GET  /events/{id}/votes
+//   GET  /events/{id}/trending
+//   GET  /events/{id}/audience
+//
+// One thread runs a non-blocking poll loop over every connection. Parsed
+// requests go to the executor, keyed by event, and each connection writes
+// its replies back in request order, so clients can keep connections open
+// and pipeline requests. A request that names only a registration is first
+// sent to a worker that looks up its event, since that needs the store
+// lock, and the worker passes it on to the event's shard. Finished replies
+// wake the loop through a pipe.
+class HttpServer {
+public:
+    static const size_t MAX_HEADER_BYTES = 1 << 16;
+    static const size_t MAX_BODY_BYTES = 1 << 20;
+
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string body;
+        bool keepAlive = true;
+    };
+
+    HttpServer(RequestEngine& engine, ShardedExecutor& executor);
+    ~HttpServer();
+
+    // Binds 127.0.0.1:port; throws std::runtime_error when that fails.
+    void listen(unsigned short port);
+    // Serves until stop() is called, which is safe from a signal handler.
+    void run();
+    void stop() { running = false; }
+
+    // Takes one request off the front of buffer. Returns the bytes used, 0
+    // when the request is still incomplete; needed is set to the size of the
+    // whole request once its headers are in, or to MAX_HEADER_BYTES before.
+    // Throws std::length_error when the headers or the declared body are too
+    // large, std::invalid_argument on input that is not HTTP.
+    static size_t parseRequest(const std::string& buffer, Request& request, size_t& needed);
+    // Maps a route to its engine request; returns the HTTP status to use
+    // when the route does not exist or its path is malformed, or 0.
+    static int routeRequest(const Request& request, nlohmann::json& engineRequest);
+
+private:
+    using SocketHandle = std::uintptr_t;
+
+    struct Wakeup;
+
+    struct PendingReply {
+        std::future<std::string> reply;
+        bool keepAlive = true;
+        bool booking = false;
+    };
+
+    struct Connection {
+        SocketHandle socket;
+        std::string input;
+        // Bytes the request at the front of input needs; reading stops there.
+        size_t inputLimit = MAX_HEADER_BYTES;
+        std::string output;
+        std::deque<PendingReply> pending;
+        bool closing = false;
+        bool broken = false;
+    };
+
+    RequestEngine& engine;
+    ShardedExecutor& executor;
+    SocketHandle listener;
+    std::atomic<bool> running{ false };
+    std::vector<std::unique_ptr<Connection>> connections;
+    // Shared with the queued jobs, which may still finish after the server.
+    std::shared_ptr<Wakeup> wakeup;
+
+    void acceptConnections();
+    void readFrom(Connection& connection);
+    void dispatchRequests(Connection& connection);
+    void submitRequest(Connection& connection, const nlohmann::json& engineRequest, bool keepAlive);
+    void rejectRequest(Connection& connection, int status, const std::string& message);
+    void collectReplies(Connection& connection);
+    void writeTo(Connection& connection);
+    static std::string response(int status, const std::string& body, bool keepAlive);
+    static std::future<std::string> readyReply(const std::string& reply);
+};
@@ -0,0 +1,56 @@
+#include "HyperLogLog.h"
+#include <cmath>
+#include <functional>
+
+// std::hash may leave the high bits weak; the splitmix64 finalizer spreads
+// every input bit over the register index and the rank.
+static uint64_t mixHash(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+HyperLogLog::HyperLogLog() : registers(REGISTERS, 0), inverseSum(static_cast<double>(REGISTERS)), zeroRegisters(REGISTERS) {}
+
+void HyperLogLog::add(const std::string& item) {
+    uint64_t hash = mixHash(static_cast<uint64_t>(std::hash<std::string>()(item)));
+    size_t index = static_cast<size_t>(hash >> (64 - PRECISION));
+
+    // Rank: position of the first set bit in the remaining bits.
+    uint64_t rest = hash << PRECISION;
+    uint8_t rank = 1;
+    while (rank <= 64 - PRECISION && (rest & (uint64_t(1) << 63)) == 0) {
+        rest <<= 1;
+        ++rank;
+    }
+    raise(index, rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < REGISTERS; ++i) {
+        raise(i, other.registers[i]);
+    }
+}
+
+void HyperLogLog::raise(size_t index, uint8_t rank) {
+    uint8_t& current = registers[index];
+    if (rank <= current) {
+        return;
+    }
+    inverseSum += std::ldexp(1.0, -rank) - std::ldexp(1.0, -current);
+    if (current == 0) {
+        --zeroRegisters;
+    }
+    current = rank;
+}
+
+long long HyperLogLog::count() const {
+    const double m = static_cast<double>(REGISTERS);
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / inverseSum;
+    // Small counts leave registers empty; linear counting is closer there.
+    if (estimate <= 2.5 * m && zeroRegisters > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeroRegisters));
+    }
+    return std::llround(estimate);
+}
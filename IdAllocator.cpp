@@ -0,0 +1,112 @@
+#include "IdAllocator.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "FileUtils.h"
+
+static const char* COUNTER_FILE = "id_counters.txt";
+
+std::mutex& IdAllocator::lock() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<std::string, IdAllocator::Counter>& IdAllocator::counters() {
+    static std::unordered_map<std::string, Counter> table;
+    return table;
+}
+
+// Each line holds a prefix and the highest number reserved for it.
+IdAllocator::Reservations IdAllocator::readReservations() {
+    Reservations reservations;
+    std::ifstream file(COUNTER_FILE);
+    std::string prefix;
+    long long reservedUpTo;
+    while (file >> prefix >> reservedUpTo) {
+        reservations[prefix] = std::max(reservations[prefix], reservedUpTo);
+    }
+    return reservations;
+}
+
+void IdAllocator::writeReservations(const Reservations& reservations) {
+    std::ostringstream contents;
+    for (const auto& entry : reservations) {
+        contents << entry.first << ' ' << entry.second << '\n';
+    }
+    if (!FileManagement::writeFileAtomically(COUNTER_FILE, contents.str())) {
+        throw std::runtime_error("Unable to save ID counters.");
+    }
+}
+
+// Starts a new block past everything any process has reserved. The file is
+// re-read under its lock and every prefix keeps the larger of the file's and
+// this process's value, so a stale or lost file cannot hand a block out twice.
+void IdAllocator::reserveBlock(Counter& counter, const std::string& prefix, long long count) {
+    FileManagement::FileLock fileLock;
+    if (!fileLock.lock(std::string(COUNTER_FILE) + ".lock")) {
+        throw std::runtime_error("Unable to lock ID counters.");
+    }
+
+    Reservations reservations = readReservations();
+    for (const auto& entry : counters()) {
+        long long& reservedUpTo = reservations[entry.first];
+        reservedUpTo = std::max(reservedUpTo, entry.second.reservedUpTo);
+    }
+    long long next = std::max(counter.next, reservations[prefix] + 1);
+    reservations[prefix] = next + count - 1 + BLOCK_SIZE;
+    writeReservations(reservations);
+
+    // Only taken once the block is on disk.
+    counter.next = next;
+    counter.reservedUpTo = reservations[prefix];
+}
+
+// The first reservation for a prefix in this process also checks the records
+// already on disk, so a lost or stale counter file cannot cause a reused ID.
+// highestInUse runs outside the lock because it may load an entity table.
+long long IdAllocator::reserve(const std::string& prefix, long long count, const std::function<long long()>& highestInUse) {
+    bool checked;
+    {
+        std::lock_guard<std::mutex> guard(lock());
+        checked = counters()[prefix].checked;
+    }
+    long long highest = !checked && highestInUse ? highestInUse() : 0;
+
+    std::lock_guard<std::mutex> guard(lock());
+    Counter& counter = counters()[prefix];
+    if (!counter.checked) {
+        counter.next = std::max(counter.next, highest + 1);
+        counter.checked = true;
+    }
+
+    if (counter.next + count - 1 > counter.reservedUpTo) {
+        reserveBlock(counter, prefix, count);
+    }
+    long long first = counter.next;
+    counter.next += count;
+    return first;
+}
+
+std::string IdAllocator::format(const std::string& prefix, long long number, int width) {
+    std::string digits = std::to_string(number);
+    if (static_cast<int>(digits.size()) < width) {
+        digits.insert(0, width - digits.size(), '0');
+    }
+    return prefix + digits;
+}
+
+long long IdAllocator::numberOf(const std::string& id, const std::string& prefix) {
+    if (id.size() <= prefix.size() || id.compare(0, prefix.size(), prefix) != 0) {
+        return 0;
+    }
+    long long number = 0;
+    for (size_t i = prefix.size(); i < id.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(id[i]))) {
+            return 0;
+        }
+        number = number * 10 + (id[i] - '0');
+    }
+    return number;
+}
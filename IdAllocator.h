@@ -0,0 +1,46 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Process-wide, persisted counters that hand out record numbers per ID prefix
+// ("EV", "REG", ...). Numbers are reserved on disk in blocks, so most calls
+// never touch the file; numbers left in a block when the process exits are
+// skipped rather than reused, which keeps IDs unique after a crash. Blocks
+// are taken under a lock on the counter file after re-reading it, so
+// processes sharing the data files never get the same block.
+class IdAllocator {
+public:
+    static const long long BLOCK_SIZE = 64;
+
+    // Returns the first of count consecutive unused numbers for prefix. The
+    // first time a prefix is used in a process, highestInUse gives the largest
+    // number already taken by existing records.
+    static long long reserve(const std::string& prefix, long long count, const std::function<long long()>& highestInUse);
+
+    static long long next(const std::string& prefix, const std::function<long long()>& highestInUse) {
+        return reserve(prefix, 1, highestInUse);
+    }
+
+    // prefix followed by number, zero-padded to at least width digits.
+    static std::string format(const std::string& prefix, long long number, int width = 3);
+
+    // Numeric part of id when it starts with prefix, otherwise 0.
+    static long long numberOf(const std::string& id, const std::string& prefix);
+
+private:
+    struct Counter {
+        long long next = 1;
+        long long reservedUpTo = 0;
+        bool checked = false;
+    };
+
+    typedef std::unordered_map<std::string, long long> Reservations;
+
+    static std::mutex& lock();
+    static std::unordered_map<std::string, Counter>& counters();
+    static void reserveBlock(Counter& counter, const std::string& prefix, long long count);
+    static Reservations readReservations();
+    static void writeReservations(const Reservations& reservations);
+};
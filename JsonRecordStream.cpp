@@ -0,0 +1,160 @@
+#include "JsonRecordStream.h"
+
+JsonRecordStream::JsonRecordStream(Callback onRecord) : onRecord(std::move(onRecord)) {
+}
+
+JsonRecordStream::JsonRecordStream(Callback onRecord, const std::string& filterField, const std::string& filterValue)
+    : onRecord(std::move(onRecord)), filtered(true), filterField(filterField), filterValue(filterValue) {
+}
+
+void JsonRecordStream::parse(std::string_view text) {
+    if (!nlohmann::json::sax_parse(text.begin(), text.end(), this)) {
+        throw std::runtime_error(error.empty() ? "Data file does not hold an array of records." : error);
+    }
+}
+
+// Depth 0 is outside the array, depth 1 is inside it and depth 2 is inside a record.
+bool JsonRecordStream::addValue(nlohmann::json&& value) {
+    if (depth == 0) {
+        return value.is_null();
+    }
+    if (depth == 1) {
+        return false;
+    }
+    if (skipping) {
+        return true;
+    }
+
+    nlohmann::json* parent = containers.back();
+    if (parent->is_array()) {
+        parent->push_back(std::move(value));
+    }
+    else {
+        *pendingValue = std::move(value);
+    }
+    return true;
+}
+
+bool JsonRecordStream::openContainer(nlohmann::json&& container) {
+    if (depth == 0) {
+        if (!container.is_array()) {
+            return false;
+        }
+        depth++;
+        return true;
+    }
+
+    if (depth == 1) {
+        if (!container.is_object()) {
+            return false;
+        }
+        record = nlohmann::json::object();
+        containers.assign(1, &record);
+        skipping = false;
+        matched = false;
+        atFilterField = false;
+        depth++;
+        return true;
+    }
+
+    depth++;
+    if (skipping) {
+        return true;
+    }
+    nlohmann::json* parent = containers.back();
+    if (parent->is_array()) {
+        parent->push_back(std::move(container));
+        containers.push_back(&parent->back());
+    }
+    else {
+        *pendingValue = std::move(container);
+        containers.push_back(pendingValue);
+    }
+    return true;
+}
+
+bool JsonRecordStream::closeContainer() {
+    depth--;
+    if (depth == 0) {
+        return true;
+    }
+    if (depth == 1) {
+        if (!skipping && (!filtered || matched)) {
+            onRecord(record);
+        }
+        record = nullptr;
+        containers.clear();
+        return true;
+    }
+    if (!skipping) {
+        containers.pop_back();
+    }
+    return true;
+}
+
+bool JsonRecordStream::null() {
+    return addValue(nullptr);
+}
+
+bool JsonRecordStream::boolean(bool value) {
+    return addValue(value);
+}
+
+bool JsonRecordStream::number_integer(number_integer_t value) {
+    return addValue(value);
+}
+
+bool JsonRecordStream::number_unsigned(number_unsigned_t value) {
+    return addValue(value);
+}
+
+bool JsonRecordStream::number_float(number_float_t value, const string_t&) {
+    return addValue(value);
+}
+
+bool JsonRecordStream::string(string_t& value) {
+    if (depth == 2 && atFilterField) {
+        if (value == filterValue) {
+            matched = true;
+        }
+        else {
+            skipping = true;
+        }
+    }
+    return addValue(std::move(value));
+}
+
+bool JsonRecordStream::binary(binary_t& value) {
+    return addValue(nlohmann::json::binary(std::move(value)));
+}
+
+bool JsonRecordStream::start_object(std::size_t) {
+    return openContainer(nlohmann::json::object());
+}
+
+bool JsonRecordStream::key(string_t& value) {
+    if (depth == 2) {
+        atFilterField = filtered && value == filterField;
+    }
+    if (!skipping) {
+        pendingValue = &(*containers.back())[value];
+    }
+    return true;
+}
+
+bool JsonRecordStream::end_object() {
+    return closeContainer();
+}
+
+bool JsonRecordStream::start_array(std::size_t) {
+    return openContainer(nlohmann::json::array());
+}
+
+bool JsonRecordStream::end_array() {
+    return closeContainer();
+}
+
+bool JsonRecordStream::parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) {
+    error = ex.what();
+    return false;
+}
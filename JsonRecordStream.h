@@ -0,0 +1,72 @@
+#pragma once
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// SAX handler for a file holding one JSON array of records. Each element is
+// built as its own small document and handed to the callback, so the whole
+// array is never held in memory. With a filter, an element whose top-level
+// field holds a different string value is dropped as soon as that value is
+// read and the rest of it is skipped without being built.
+class JsonRecordStream : public nlohmann::json_sax<nlohmann::json> {
+public:
+    using Callback = std::function<void(nlohmann::json& record)>;
+
+    explicit JsonRecordStream(Callback onRecord);
+    JsonRecordStream(Callback onRecord, const std::string& filterField, const std::string& filterValue);
+
+    // Throws std::runtime_error when the text is not an array of objects.
+    void parse(std::string_view text);
+
+    bool null() override;
+    bool boolean(bool value) override;
+    bool number_integer(number_integer_t value) override;
+    bool number_unsigned(number_unsigned_t value) override;
+    bool number_float(number_float_t value, const string_t& text) override;
+    bool string(string_t& value) override;
+    bool binary(binary_t& value) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& value) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception& ex) override;
+
+private:
+    Callback onRecord;
+    bool filtered = false;
+    std::string filterField;
+    std::string filterValue;
+
+    int depth = 0;
+    nlohmann::json record;
+    std::vector<nlohmann::json*> containers;
+    nlohmann::json* pendingValue = nullptr;
+    bool skipping = false;
+    bool matched = false;
+    bool atFilterField = false;
+    std::string error;
+
+    bool addValue(nlohmann::json&& value);
+    bool openContainer(nlohmann::json&& container);
+    bool closeContainer();
+};
+
+namespace JsonStream {
+    // Calls onRecord with each element of the array converted to T.
+    template <typename T, typename Callback>
+    void forEachRecord(std::string_view text, Callback&& onRecord) {
+        JsonRecordStream stream([&](nlohmann::json& record) { onRecord(record.get<T>()); });
+        stream.parse(text);
+    }
+
+    // Calls onRecord with each element whose string field equals value.
+    template <typename T, typename Callback>
+    void forEachRecordWhere(std::string_view text, const std::string& field, const std::string& value, Callback&& onRecord) {
+        JsonRecordStream stream([&](nlohmann::json& record) { onRecord(record.get<T>()); }, field, value);
+        stream.parse(text);
+    }
+}
@@ -7,9 +7,8 @@
 #include <cctype>
 
 namespace LoginModule {
-    LoginSystem::LoginSystem() : organizerCounter(0), customerCounter(0) {
+    LoginSystem::LoginSystem() {
         loadUsers();
-        updateCounters();
         createAdmin();
     }
 
@@ -74,37 +73,6 @@ namespace LoginModule {
         dm.saveData<User>(users, "users.json");
     }
 
-    void LoginSystem::updateCounters() {
-        int maxOrgCounter = 0;
-        int maxCusCounter = 0;
-
-        for (const auto& user : users) {
-            if (user.userType == UserType::ORGANIZER) {
-                try {
-                    std::string idNum = user.userId.substr(3);
-                    int num = std::stoi(idNum);
-                    maxOrgCounter = std::max(maxOrgCounter, num);
-                }
-                catch (const std::exception&) {
-
-                }
-            }
-            else if (user.userType == UserType::CUSTOMER) {
-                try {
-                    std::string idNum = user.userId.substr(3);
-                    int num = std::stoi(idNum);
-                    maxCusCounter = std::max(maxCusCounter, num);
-                }
-                catch (const std::exception&) {
-
-                }
-            }
-        }
-
-        organizerCounter = maxOrgCounter;
-        customerCounter = maxCusCounter;
-    }
-
     void LoginSystem::createAdmin() {
         for (const auto& user : users) {
             if (user.userType == UserType::ADMIN) {
@@ -126,17 +94,7 @@ namespace LoginModule {
     }
 
     std::string LoginSystem::generateUserId(UserType userType) {
-        if (userType == UserType::ORGANIZER) {
-            organizerCounter++;
-            std::string numStr = std::to_string(organizerCounter);
-            return "ORG" + std::string(3 - std::min(3, (int)numStr.length()), '0') + numStr;
-        }
-        else if (userType == UserType::CUSTOMER) {
-            customerCounter++;
-            std::string numStr = std::to_string(customerCounter);
-            return "CUS" + std::string(3 - std::min(3, (int)numStr.length()), '0') + numStr;
-        }
-        return "";
+        return dm.generateNewUserId(userType);
     }
 
     bool LoginSystem::isUniqueUsername(const std::string& username) {
@@ -21,15 +21,12 @@ namespace LoginModule {
         Validation validation;
         DataManager dm;
         std::vector<User> users;
-        int organizerCounter;
-        int customerCounter;
         User currentUser;
         std::string userFile = "users.json";
 
         // Core functionality
         void loadUsers();
         void saveUsers();
-        void updateCounters();
         void createAdmin();
 
         // User ID generation
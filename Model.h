@@ -74,6 +74,20 @@ NLOHMANN_JSON_SERIALIZE_ENUM(UserType, {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(User, userId, username, passwordHash, email, phoneNumber, userType, isDeleted)
 };
 
+// A block of rows with the same number of seats. Sections are stacked in
+// order, so seat rows are numbered across the whole venue.
+struct VenueSection {
+    std::string name;
+    int rows = 0;
+    int seatsPerRow = 0;
+
+    bool operator==(const VenueSection& other) const {
+        return name == other.name && rows == other.rows && seatsPerRow == other.seatsPerRow;
+    }
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(VenueSection, name, rows, seatsPerRow)
+};
+
 struct Event {
     std::string eventId;
     std::string eventName;
@@ -86,14 +100,16 @@ struct Event {
     EventStatus status;
     int totalSeats = 100;
     int availableSeats = 100;
+    // Empty for the classic layout: rows of ten seats up to totalSeats.
+    std::vector<VenueSection> sections;
     bool isDeleted = false;
 
     void softDelete() {
         this->isDeleted = true;
     }
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(Event, eventId, eventName, description, eventDate, startTime, endTime, organizerId, ticketPrice,
-        status, totalSeats, isDeleted)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(Event, eventId, eventName, description, eventDate, startTime, endTime, organizerId, ticketPrice,
+        status, totalSeats, sections, isDeleted)
 };
 
 struct Seat {
@@ -180,14 +196,16 @@ struct Vote {
     std::string voteId;
     std::string songId;
     std::string registrationId;
-    int voteWeight;
+    int voteWeight = 1;
     bool isDeleted = false;
+    // When the ballot was cast; 0 for votes saved before it was recorded.
+    time_t voteTime = 0;
 
     void softDelete() {
         this->isDeleted = true;
     }
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(Vote, voteId, songId, registrationId, voteWeight, isDeleted)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(Vote, voteId, songId, registrationId, voteWeight, isDeleted, voteTime)
 };
 
 struct Attendance {
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DataManager.h"
+
+// Times the organizer monitoring screens as the data grows.
+//   MonitoringBench [--dir monitoring_bench] [--max 80000] [--runs 5]
+//
+// Writes generated users, events, registrations, payments, refunds and
+// attendances into --dir (its data files are overwritten), starting at 1250
+// registrations per event and doubling up to --max. Each builder is timed
+// over --runs passes and the fastest is shown. The rows joined per
+// registration do not change, so a linear builder keeps the last column
+// flat.
+
+static const int EVENT_COUNT = 2;
+static const time_t START_TIME = 2000000000;
+
+// Every event gets `perEvent` one-seat registrations, each paid; every
+// tenth payment is refunded and every other registration has checked in.
+void writeData(DataManager& dm, int perEvent) {
+    std::vector<User> users;
+    std::vector<Event> events;
+    std::vector<Registration> registrations;
+    std::vector<Payment> payments;
+    std::vector<Refund> refunds;
+    std::vector<Attendance> attendances;
+
+    int customerCount = std::max(1, perEvent / 4);
+    for (int i = 0; i < customerCount; ++i) {
+        User user;
+        user.userId = "CUS" + std::to_string(i + 1);
+        user.username = "customer" + std::to_string(i + 1);
+        user.userType = UserType::CUSTOMER;
+        users.push_back(user);
+    }
+
+    int number = 0;
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        Event event;
+        event.eventId = "EV" + std::to_string(e + 1);
+        event.eventName = "Event " + std::to_string(e + 1);
+        event.eventDate = START_TIME;
+        event.startTime = START_TIME;
+        event.endTime = START_TIME + 10000;
+        event.status = EventStatus::SCHEDULED;
+        event.totalSeats = perEvent;
+        event.availableSeats = 0;
+        events.push_back(event);
+
+        for (int i = 0; i < perEvent; ++i, ++number) {
+            Registration reg;
+            reg.registrationId = "REG" + std::to_string(number + 1);
+            reg.customerId = users[number % customerCount].userId;
+            reg.eventId = event.eventId;
+            reg.registerTime = START_TIME - 86400;
+            reg.registrationStatus = RegistrationStatus::COMPLETED;
+            Seat seat;
+            seat.seatId = "R" + std::to_string(i / 10 + 1) + "C" + std::to_string(i % 10 + 1);
+            seat.row = std::to_string(i / 10 + 1);
+            seat.column = std::to_string(i % 10 + 1);
+            seat.registrationId = reg.registrationId;
+            seat.status = SeatStatus::RESERVED;
+            reg.seats.push_back(seat);
+            registrations.push_back(reg);
+
+            Payment payment;
+            payment.paymentId = "PAY" + std::to_string(number + 1);
+            payment.registrationId = reg.registrationId;
+            payment.amount = 50;
+            payment.paymentDate = reg.registerTime;
+            payment.paymentMethod = PaymentMethod::E_WALLET;
+            payment.paymentStatus = number % 10 == 0 ? PaymentStatus::REFUNDED : PaymentStatus::COMPLETED;
+            payments.push_back(payment);
+
+            if (payment.paymentStatus == PaymentStatus::REFUNDED) {
+                Refund refund;
+                refund.refundId = "RFD" + std::to_string(number + 1);
+                refund.paymentId = payment.paymentId;
+                refund.refundAmount = payment.amount;
+                refund.refundDate = reg.registerTime + 3600;
+                refund.reason = "Benchmark";
+                refunds.push_back(refund);
+            }
+            if (number % 2 == 0) {
+                Attendance attendance;
+                attendance.attendanceId = "ATD" + std::to_string(number + 1);
+                attendance.registrationId = reg.registrationId;
+                attendance.attendanceStatus = AttendanceStatus::PRESENT;
+                attendance.attendanceTime = START_TIME + 60;
+                attendances.push_back(attendance);
+            }
+        }
+    }
+
+    dm.saveData(users, dm.userFileName);
+    dm.saveData(events, dm.eventFileName);
+    dm.saveData(registrations, dm.registrationFileName);
+    dm.saveData(payments, dm.paymentFileName);
+    dm.saveData(refunds, dm.refundFileName);
+    dm.saveData(attendances, dm.attendanceFileName);
+    dm.saveData(std::vector<Performance>(), dm.performanceFileName);
+    dm.saveData(std::vector<Vote>(), dm.voteFileName);
+}
+
+// Milliseconds of the fastest of `runs` calls.
+double fastest(int runs, const std::function<void()>& build) {
+    double best = 0;
+    for (int run = 0; run < runs; ++run) {
+        auto begin = std::chrono::steady_clock::now();
+        build();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        if (run == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    std::string directory = "monitoring_bench";
+    int maxRegistrations = 80000;
+    int runs = 5;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            directory = argv[++i];
+        }
+        else if (arg == "--max" && i + 1 < argc) {
+            maxRegistrations = std::atoi(argv[++i]);
+        }
+        else if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "Usage: MonitoringBench [--dir monitoring_bench] [--max 80000] [--runs 5]\n";
+            return 1;
+        }
+    }
+
+    try {
+        std::filesystem::create_directories(directory);
+        std::filesystem::current_path(directory);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Unable to use " << directory << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << std::setw(14) << "registrations" << std::setw(12) << "sales ms" << std::setw(12) << "refunds ms"
+        << std::setw(14) << "attendance ms" << std::setw(12) << "seats ms" << std::setw(16) << "ns/registration" << "\n";
+
+    try {
+        DataManager dm;
+        for (int perEvent = 1250; perEvent * EVENT_COUNT <= maxRegistrations; perEvent *= 2) {
+            writeData(dm, perEvent);
+            Event event = dm.getAllActiveEvents().front();
+
+            double sales = fastest(runs, [&] {
+                std::vector<std::vector<std::string>> rows;
+                double totalSales = 0;
+                dm.loadCompletedSalesOfEvent(rows, totalSales, event);
+            });
+            double refunds = fastest(runs, [&] {
+                std::vector<std::vector<std::string>> rows;
+                dm.loadRefundedSalesOfEvent(rows, event);
+            });
+            double attendance = fastest(runs, [&] { dm.loadAttendanceMonitoring(event); });
+            double seats = fastest(runs, [&] { dm.loadSeatMonitoring(event); });
+
+            int registrations = perEvent * EVENT_COUNT;
+            double total = sales + refunds + attendance + seats;
+            std::cout << std::fixed << std::setprecision(2)
+                << std::setw(14) << registrations << std::setw(12) << sales << std::setw(12) << refunds
+                << std::setw(14) << attendance << std::setw(12) << seats
+                << std::setw(16) << std::setprecision(0) << total * 1e6 / registrations << "\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
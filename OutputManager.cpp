@@ -155,27 +155,45 @@ void OutputManager::displayTable(const std::vector<std::string>& header, const s
     std::cout << std::endl;
 }
 
-void OutputManager::printSeatingChart(const std::vector<std::vector<bool>>& seats) {
+// Rows wider than this print one character per seat, with the last digit of
+// each column number as the header, so large sections still fit on screen.
+static const size_t COMPACT_CHART_WIDTH = 30;
+
+void OutputManager::printSeatHeader(size_t columns, bool compact) {
     print("      Seat\nRow   ", OutputManager::Color::CYAN);
     setColour(OutputManager::Color::CYAN);
-    for (int i = 0; i < seats[0].size(); ++i) {
-        std::cout << std::setw(2) << i + 1;
+    for (size_t i = 0; i < columns; ++i) {
+        if (compact) {
+            std::cout << (i + 1) % 10;
+        }
+        else {
+            std::cout << std::setw(2) << i + 1;
+        }
     }
-    std::cout << "\n--------------------------\n";
+    std::cout << "\n" << std::string(6 + columns * (compact ? 1 : 2), '-') << "\n";
     reset();
+}
+
+void OutputManager::printSeatingChart(const std::vector<std::vector<bool>>& seats, int firstRow) {
+    size_t columns = 0;
+    for (const auto& row : seats) {
+        columns = std::max(columns, row.size());
+    }
+    bool compact = columns > COMPACT_CHART_WIDTH;
+    printSeatHeader(columns, compact);
 
     for (int i = 0; i < seats.size(); ++i) {
         setColour(OutputManager::Color::CYAN);
-        std::cout << std::setw(3) << i + 1 << " | ";
+        std::cout << std::setw(3) << firstRow + i << " | ";
         reset();
 
         setColour(OutputManager::Color::CYAN);
         for (int j = 0; j < seats[i].size(); ++j) {
             if (seats[i][j]) {
-                print(" X", OutputManager::Color::RED);
+                print(compact ? "X" : " X", OutputManager::Color::RED);
             }
             else {
-                print(" O", OutputManager::Color::GREEN);
+                print(compact ? "O" : " O", OutputManager::Color::GREEN);
             }
         }
         std::cout << std::endl;
@@ -186,29 +204,28 @@ void OutputManager::printSeatingChart(const std::vector<std::vector<bool>>& seat
     println("X = Occupied", OutputManager::Color::RED);
 }
 
-void OutputManager::printAttendanceSeat(const std::vector<std::vector<int>>& seats) {
-    print("      Seat\nRow   ", OutputManager::Color::CYAN);
-    setColour(OutputManager::Color::CYAN);
-    for (int i = 0; i < seats[0].size(); ++i) {
-        std::cout << std::setw(2) << i + 1;
+void OutputManager::printAttendanceSeat(const std::vector<std::vector<int>>& seats, int firstRow) {
+    size_t columns = 0;
+    for (const auto& row : seats) {
+        columns = std::max(columns, row.size());
     }
-    std::cout << "\n--------------------------\n";
-    reset();
+    bool compact = columns > COMPACT_CHART_WIDTH;
+    printSeatHeader(columns, compact);
 
     for (int i = 0; i < seats.size(); ++i) {
         setColour(OutputManager::Color::CYAN);
-        std::cout << std::setw(3) << i + 1 << " | ";
+        std::cout << std::setw(3) << firstRow + i << " | ";
         reset();
 
         for (int j = 0; j < seats[i].size(); ++j) {
             if (seats[i][j] == 1) {
-                print(" P", OutputManager::Color::GREEN);  // Present
+                print(compact ? "P" : " P", OutputManager::Color::GREEN);  // Present
             }
             else if (seats[i][j] == 0) {
-                print(" A", OutputManager::Color::RED);    // Absent (registered but not present)
+                print(compact ? "A" : " A", OutputManager::Color::RED);    // Absent (registered but not present)
             }
             else {
-                print(" -", OutputManager::Color::WHITE);  // Not registered/available
+                print(compact ? "-" : " -", OutputManager::Color::WHITE);  // Not registered/available
             }
         }
         std::cout << std::endl;
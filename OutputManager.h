@@ -36,7 +36,11 @@ public:
     void printMenu(const std::vector<std::string> menu);
     void drawHorizontalLine(const std::vector<size_t>& columnWidths, unsigned char left, unsigned char mid, unsigned char right);
     void displayTable(const std::vector<std::string>& header, const std::vector<std::vector<std::string>>& rows);
-    void printSeatingChart(const std::vector<std::vector<bool>>& seats);
-    void printAttendanceSeat(const std::vector<std::vector<int>>& seats);
+    // firstRow is the venue row number of seats[0], for charts of one section.
+    void printSeatingChart(const std::vector<std::vector<bool>>& seats, int firstRow = 1);
+    void printAttendanceSeat(const std::vector<std::vector<int>>& seats, int firstRow = 1);
     void clearScreen();
+
+private:
+    void printSeatHeader(size_t columns, bool compact);
 };
\ No newline at end of file
@@ -85,19 +85,17 @@ namespace PaymentCheckout {
     }
 
     std::vector<Registration> PaymentCheckout::getUserPendingRegistrations() {
-        auto registrations = dm.loadData<Registration>("registrations.json");
+        auto registrations = dm.loadDataWhere<Registration>(dm.registrationFileName, "customerId", user.userId);
         std::vector<Registration> pendingRegistrations;
 
         for (const auto& reg : registrations) {
-            if (reg.customerId == user.userId &&
-                reg.registrationStatus == RegistrationStatus::PENDING) {
+            if (reg.registrationStatus == RegistrationStatus::PENDING) {
 
-                auto payments = dm.loadData<Payment>("payments.json");
+                auto payments = dm.getPaymentsForRegistration(reg.registrationId);
                 bool hasCompletedPayment = false;
 
                 for (const auto& payment : payments) {
-                    if (payment.registrationId == reg.registrationId &&
-                        payment.paymentStatus == PaymentStatus::COMPLETED) {
+                    if (payment.paymentStatus == PaymentStatus::COMPLETED) {
                         hasCompletedPayment = true;
                         break;
                     }
@@ -300,25 +298,20 @@ namespace PaymentCheckout {
     }
 
     void PaymentCheckout::ensureSeatsReservedForRegistration(const std::string& registrationId) {
-        auto registrations = dm.loadData<Registration>("registrations.json");
+        Registration reg = dm.getRegistrationFromRegistrationId(registrationId);
         bool changed = false;
-        for (auto& reg : registrations) {
-            if (reg.registrationId == registrationId) {
-                for (auto& seat : reg.seats) {
-                    if (seat.status != SeatStatus::RESERVED) {
-                        seat.status = SeatStatus::RESERVED;
-                        changed = true;
-                    }
-                    if (seat.registrationId.empty()) {
-                        seat.registrationId = registrationId;
-                        changed = true;
-                    }
-                }
-                break;
+        for (auto& seat : reg.seats) {
+            if (seat.status != SeatStatus::RESERVED) {
+                seat.status = SeatStatus::RESERVED;
+                changed = true;
+            }
+            if (seat.registrationId.empty()) {
+                seat.registrationId = registrationId;
+                changed = true;
             }
         }
         if (changed) {
-            dm.saveData(registrations, "registrations.json");
+            dm.saveRecord(reg, dm.registrationFileName);
         }
     }
 
@@ -337,33 +330,25 @@ namespace PaymentCheckout {
                 payment.paymentMethod = method;
                 payment.paymentStatus = PaymentStatus::COMPLETED;
 
-                auto payments = dm.loadData<Payment>("payments.json");
-                payments.push_back(payment);
-                dm.saveData(payments, "payments.json");
+                dm.saveRecord(payment, dm.paymentFileName);
 
-                auto registrations = dm.loadData<Registration>("registrations.json");
-                for (auto& reg : registrations) {
-                    if (reg.registrationId == registration.registrationId) {
-                        reg.registrationStatus = RegistrationStatus::COMPLETED;
+                Registration reg = dm.getRegistrationFromRegistrationId(registration.registrationId);
+                if (!reg.registrationId.empty()) {
+                    reg.registrationStatus = RegistrationStatus::COMPLETED;
 
-                        for (auto& seat : reg.seats) {
-                            seat.status = SeatStatus::RESERVED;
-                            if (seat.registrationId.empty()) seat.registrationId = reg.registrationId;
-                        }
-                        break;
+                    for (auto& seat : reg.seats) {
+                        seat.status = SeatStatus::RESERVED;
+                        if (seat.registrationId.empty()) seat.registrationId = reg.registrationId;
                     }
+                    dm.saveRecord(reg, dm.registrationFileName);
                 }
-                dm.saveData(registrations, "registrations.json");
 
-                auto events = dm.loadData<Event>("events.json");
-                for (auto& ev : events) {
-                    if (ev.eventId == event.eventId) {
-                        ev.availableSeats -= registration.seats.size();
-                        if (ev.availableSeats < 0) ev.availableSeats = 0;
-                        break;
-                    }
+                Event ev = dm.getEventFromEventId(event.eventId);
+                if (!ev.eventId.empty()) {
+                    ev.availableSeats -= registration.seats.size();
+                    if (ev.availableSeats < 0) ev.availableSeats = 0;
+                    dm.saveRecord(ev, dm.eventFileName);
                 }
-                dm.saveData(events, "events.json");
 
                 ensureSeatsReservedForRegistration(registration.registrationId);
 
@@ -391,18 +376,11 @@ namespace PaymentCheckout {
     }
 
     std::vector<Payment> PaymentCheckout::getUserCompletedPayments() {
-        auto payments = dm.loadData<Payment>("payments.json");
         std::vector<Payment> userPayments;
 
-        for (const auto& payment : payments) {
-            auto registrations = dm.loadData<Registration>("registrations.json");
-            for (const auto& reg : registrations) {
-                if (reg.registrationId == payment.registrationId &&
-                    reg.customerId == user.userId &&
-                    payment.paymentStatus == PaymentStatus::COMPLETED) {
-                    userPayments.push_back(payment);
-                    break;
-                }
+        for (const auto& payment : getUserAllPayments()) {
+            if (payment.paymentStatus == PaymentStatus::COMPLETED) {
+                userPayments.push_back(payment);
             }
         }
 
@@ -410,33 +388,25 @@ namespace PaymentCheckout {
     }
 
     void PaymentCheckout::releaseSeatsOnRefund(const std::string& registrationId) {
-        auto registrations = dm.loadData<Registration>("registrations.json");
-        Registration* targetReg = nullptr;
-        for (auto& reg : registrations) {
-            if (reg.registrationId == registrationId) {
-                for (auto& seat : reg.seats) {
-                    seat.status = SeatStatus::AVAILABLE;
-                    seat.registrationId.clear();
-                }
-                reg.registrationStatus = RegistrationStatus::CANCELLED;
-                targetReg = &reg;
-                break;
-            }
+        Registration targetReg = dm.getRegistrationFromRegistrationId(registrationId);
+        if (targetReg.registrationId.empty()) {
+            return;
         }
-        dm.saveData(registrations, "registrations.json");
-
-        if (targetReg) {
-            auto events = dm.loadData<Event>("events.json");
-            for (auto& ev : events) {
-                if (ev.eventId == targetReg->eventId) {
-                    ev.availableSeats += targetReg->seats.size();
-                    if (ev.availableSeats > ev.totalSeats) {
-                        ev.availableSeats = ev.totalSeats;
-                    }
-                    break;
-                }
+
+        for (auto& seat : targetReg.seats) {
+            seat.status = SeatStatus::AVAILABLE;
+            seat.registrationId.clear();
+        }
+        targetReg.registrationStatus = RegistrationStatus::CANCELLED;
+        dm.saveRecord(targetReg, dm.registrationFileName);
+
+        Event ev = dm.getEventFromEventId(targetReg.eventId);
+        if (!ev.eventId.empty()) {
+            ev.availableSeats += targetReg.seats.size();
+            if (ev.availableSeats > ev.totalSeats) {
+                ev.availableSeats = ev.totalSeats;
             }
-            dm.saveData(events, "events.json");
+            dm.saveRecord(ev, dm.eventFileName);
         }
     }
 
@@ -449,21 +419,13 @@ namespace PaymentCheckout {
 
         for (size_t i = 0; i < userPayments.size(); i++) {
             const auto& payment = userPayments[i];
-            auto registrations = dm.loadData<Registration>("registrations.json");
-
-            const Registration* reg = nullptr;
-            for (const auto& r : registrations) {
-                if (r.registrationId == payment.registrationId) {
-                    reg = &r;
-                    break;
-                }
-            }
+            Registration reg = dm.getRegistrationFromRegistrationId(payment.registrationId);
 
             std::string eventName = "";
             bool eligible = true;
 
-            if (reg) {
-                Event event = getEventById(reg->eventId);
+            if (!reg.registrationId.empty()) {
+                Event event = getEventById(reg.eventId);
                 eventName = event.eventName;
 
                 time_t refundDeadline = event.startTime - (2 * 60 * 60);
@@ -517,17 +479,10 @@ namespace PaymentCheckout {
 
             Payment selectedPayment = eligiblePayments[choice];
 
-            auto registrations = dm.loadData<Registration>("registrations.json");
-            const Registration* reg = nullptr;
-            for (const auto& r : registrations) {
-                if (r.registrationId == selectedPayment.registrationId) {
-                    reg = &r;
-                    break;
-                }
-            }
+            Registration reg = dm.getRegistrationFromRegistrationId(selectedPayment.registrationId);
 
-            if (reg) {
-                Event event = getEventById(reg->eventId);
+            if (!reg.registrationId.empty()) {
+                Event event = getEventById(reg.eventId);
                 time_t currentTime = time(0);
                 time_t refundDeadline = event.startTime - (2 * 60 * 60);
 
@@ -567,24 +522,17 @@ namespace PaymentCheckout {
             }
 
             Refund refund;
-            refund.refundId = "REF" + std::to_string(time(0));
+            refund.refundId = dm.generateNewRefundId();
             refund.paymentId = selectedPayment.paymentId;
             refund.refundAmount = selectedPayment.amount * 0.8;
             refund.refundDate = time(0);
             refund.reason = reason;
 
-            auto payments = dm.loadData<Payment>("payments.json");
-            for (auto& p : payments) {
-                if (p.paymentId == selectedPayment.paymentId) {
-                    p.paymentStatus = PaymentStatus::REFUNDED;
-                    break;
-                }
-            }
+            Payment refundedPayment = dm.getPaymentFromPaymentId(selectedPayment.paymentId);
+            refundedPayment.paymentStatus = PaymentStatus::REFUNDED;
 
-            auto refunds = dm.loadData<Refund>("refunds.json");
-            refunds.push_back(refund);
-            dm.saveData(refunds, "refunds.json");
-            dm.saveData(payments, "payments.json");
+            dm.saveRecord(refund, dm.refundFileName);
+            dm.saveRecord(refundedPayment, dm.paymentFileName);
 
             releaseSeatsOnRefund(selectedPayment.registrationId);
 
@@ -610,13 +558,10 @@ namespace PaymentCheckout {
 
         for (const auto& payment : userPayments) {
             std::string eventName = "Unknown Event";
-            auto registrations = dm.loadData<Registration>("registrations.json");
-            for (const auto& reg : registrations) {
-                if (reg.registrationId == payment.registrationId) {
-                    Event ev = getEventById(reg.eventId);
-                    if (!ev.eventName.empty()) eventName = ev.eventName;
-                    break;
-                }
+            Registration reg = dm.getRegistrationFromRegistrationId(payment.registrationId);
+            if (!reg.registrationId.empty()) {
+                Event ev = getEventById(reg.eventId);
+                if (!ev.eventName.empty()) eventName = ev.eventName;
             }
 
             rows.push_back({
@@ -644,35 +589,25 @@ namespace PaymentCheckout {
     }
 
     std::vector<Payment> PaymentCheckout::getUserAllPayments() {
-        auto payments = dm.loadData<Payment>("payments.json");
         std::vector<Payment> userPayments;
 
-        for (const auto& payment : payments) {
-            auto registrations = dm.loadData<Registration>("registrations.json");
-            for (const auto& reg : registrations) {
-                if (reg.registrationId == payment.registrationId &&
-                    reg.customerId == user.userId) {
-                    userPayments.push_back(payment);
-                    break;
-                }
+        for (const auto& reg : dm.loadDataWhere<Registration>(dm.registrationFileName, "customerId", user.userId)) {
+            for (const auto& payment : dm.getPaymentsForRegistration(reg.registrationId)) {
+                userPayments.push_back(payment);
             }
         }
 
+        std::stable_sort(userPayments.begin(), userPayments.end(),
+            [](const Payment& a, const Payment& b) { return a.paymentDate < b.paymentDate; });
         return userPayments;
     }
 
     Event PaymentCheckout::getEventById(const std::string& eventId) {
-        auto events = dm.loadData<Event>("events.json");
-        for (const auto& event : events) {
-            if (event.eventId == eventId) {
-                return event;
-            }
-        }
-        return Event();
+        return dm.getEventFromEventId(eventId);
     }
 
     std::string PaymentCheckout::generatePaymentId() {
-        return "PAY" + std::to_string(time(0));
+        return dm.generateNewPaymentId();
     }
 
     std::string PaymentCheckout::getCurrentDateTime() {
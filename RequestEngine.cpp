@@ -0,0 +1,450 @@
+#include "RequestEngine.h"
+#include "VoteIngestor.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+RequestEngine::RequestEngine(DataManager& dm) : dm(dm) {
+    dm.loadAllTables();
+}
+
+std::string RequestEngine::handleLine(const std::string& line) {
+    nlohmann::json request;
+    try {
+        request = nlohmann::json::parse(line);
+    }
+    catch (const nlohmann::json::exception&) {
+        return nlohmann::json{ {"ok", false}, {"error", "Request is not valid JSON."} }.dump();
+    }
+    return handle(request).dump();
+}
+
+nlohmann::json RequestEngine::handle(const nlohmann::json& request) {
+    nlohmann::json response;
+    if (request.is_object() && request.contains("id")) {
+        response["id"] = request["id"];
+    }
+
+    try {
+        if (!request.is_object()) {
+            throw std::runtime_error("Request must be a JSON object.");
+        }
+        std::string op = request.value("op", "");
+        time_t now = request.value("time", static_cast<long long>(time(nullptr)));
+
+        std::unique_lock<std::shared_mutex> exclusive(exclusiveGate, std::defer_lock);
+        std::shared_lock<std::shared_mutex> shared(exclusiveGate, std::defer_lock);
+        std::unique_lock<std::mutex> eventGuard;
+        if (op != "votes") {
+            std::string eventId = shardKey(request);
+            if (eventId.empty()) {
+                exclusive.lock();
+            }
+            else {
+                shared.lock();
+                eventGuard = std::unique_lock<std::mutex>(eventLock(eventId));
+            }
+        }
+
+        nlohmann::json result;
+        std::unique_lock<DataManager::StoreMutex> guard(DataManager::storeMutex(), std::defer_lock);
+        if (op != "votes") {
+            guard.lock();
+        }
+        if (op == "book") result = book(request, now);
+        else if (op == "pay") result = pay(request, now);
+        else if (op == "vote") result = vote(request, now, guard);
+        else if (op == "checkin") result = checkIn(request, now);
+        else if (op == "cancel") result = cancel(request, now);
+        else if (op == "availability") result = availability(request);
+        else if (op == "sales") result = sales(request);
+        else if (op == "votes") result = voteCounts(request, guard);
+        else if (op == "trending") result = trending(request, now);
+        else if (op == "audience") result = audience(request);
+        else throw std::runtime_error("Unknown op '" + op + "'.");
+
+        response["ok"] = true;
+        response.update(result);
+    }
+    catch (const std::exception& e) {
+        response["ok"] = false;
+        response["error"] = e.what();
+    }
+    return response;
+}
+
+size_t RequestEngine::expireSeatHolds(time_t now) {
+    std::unique_lock<std::shared_mutex> exclusive(exclusiveGate);
+    std::lock_guard<DataManager::StoreMutex> guard(DataManager::storeMutex());
+    return dm.expireSeatHolds(now);
+}
+
+std::string RequestEngine::shardKey(const nlohmann::json& request) {
+    if (!request.is_object()) {
+        return "";
+    }
+    if (request.contains("bookings") && request["bookings"].is_array() && !request["bookings"].empty()) {
+        std::string eventId = request["bookings"][0].value("eventId", "");
+        for (const auto& booking : request["bookings"]) {
+            if (!booking.is_object() || booking.value("eventId", "") != eventId) {
+                return "";
+            }
+        }
+        return eventId;
+    }
+    if (!keyedByRegistration(request)) {
+        return request.value("eventId", "");
+    }
+    std::lock_guard<DataManager::StoreMutex> guard(DataManager::storeMutex());
+    return dm.getRegistrationFromRegistrationId(request.value("registrationId", "")).eventId;
+}
+
+bool RequestEngine::keyedByRegistration(const nlohmann::json& request) {
+    if (!request.is_object() || request.contains("bookings") || request.contains("eventId")) {
+        return false;
+    }
+    auto registrationId = request.find("registrationId");
+    return registrationId != request.end() && registrationId->is_string() && !registrationId->get<std::string>().empty();
+}
+
+std::mutex& RequestEngine::eventLock(const std::string& eventId) {
+    std::lock_guard<std::mutex> guard(eventLocksMutex);
+    std::unique_ptr<std::mutex>& lock = eventLocks[eventId];
+    if (!lock) {
+        lock.reset(new std::mutex());
+    }
+    return *lock;
+}
+
+DataManager::BookingRequest RequestEngine::bookingFrom(const nlohmann::json& booking) {
+    DataManager::BookingRequest request;
+    request.customerId = booking.value("customerId", "");
+    request.eventId = booking.value("eventId", "");
+    request.seatCount = booking.value("seatCount", 0);
+    request.seatIds = booking.value("seats", std::vector<std::string>());
+    if (request.seatIds.empty() && request.seatCount <= 0) {
+        throw std::runtime_error("A booking needs seats or a positive seatCount.");
+    }
+    return request;
+}
+
+nlohmann::json RequestEngine::describe(const Registration& registration) {
+    std::vector<std::string> seats;
+    for (const auto& seat : registration.seats) {
+        seats.push_back(seat.seatId);
+    }
+    return { {"registrationId", registration.registrationId}, {"eventId", registration.eventId}, {"seats", seats} };
+}
+
+nlohmann::json RequestEngine::book(const nlohmann::json& request, time_t now) {
+    std::vector<DataManager::BookingRequest> bookings;
+    if (request.contains("bookings")) {
+        for (const auto& booking : request.at("bookings")) {
+            bookings.push_back(bookingFrom(booking));
+        }
+    }
+    else {
+        bookings.push_back(bookingFrom(request));
+    }
+
+    std::vector<Registration> booked;
+    std::string error;
+    if (!dm.bookGroup(bookings, now, booked, error)) {
+        throw std::runtime_error(error);
+    }
+
+    if (!request.contains("bookings")) {
+        return describe(booked.front());
+    }
+    nlohmann::json registrations = nlohmann::json::array();
+    for (const auto& registration : booked) {
+        registrations.push_back(describe(registration));
+    }
+    return { {"registrations", registrations} };
+}
+
+Registration RequestEngine::activeRegistration(const nlohmann::json& request) {
+    std::string registrationId = request.value("registrationId", "");
+    Registration registration = dm.getRegistrationFromRegistrationId(registrationId);
+    if (registration.registrationId.empty() || registration.isDeleted) {
+        throw std::runtime_error("Registration " + registrationId + " not found.");
+    }
+    if (registration.registrationStatus == RegistrationStatus::CANCELLED) {
+        throw std::runtime_error("Registration " + registrationId + " is cancelled.");
+    }
+    return registration;
+}
+
+bool RequestEngine::isRefunded(const std::string& registrationId) {
+    for (const auto& payment : dm.getPaymentsForRegistration(registrationId)) {
+        if (payment.paymentStatus == PaymentStatus::REFUNDED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RequestEngine::adjustAvailableSeats(const std::string& eventId, int change) {
+    Event event = dm.getEventFromEventId(eventId);
+    if (event.eventId.empty()) {
+        return;
+    }
+    event.availableSeats += change;
+    if (event.availableSeats < 0) event.availableSeats = 0;
+    if (event.availableSeats > event.totalSeats) event.availableSeats = event.totalSeats;
+    dm.saveRecord(event, dm.eventFileName);
+}
+
+nlohmann::json RequestEngine::pay(const nlohmann::json& request, time_t now) {
+    Registration registration = activeRegistration(request);
+    for (const auto& payment : dm.getPaymentsForRegistration(registration.registrationId)) {
+        if (payment.paymentStatus == PaymentStatus::COMPLETED) {
+            throw std::runtime_error("Registration " + registration.registrationId + " is already paid.");
+        }
+    }
+    Event event = dm.getEventFromEventId(registration.eventId);
+
+    Payment payment;
+    payment.paymentId = dm.generateNewPaymentId();
+    payment.registrationId = registration.registrationId;
+    payment.amount = event.ticketPrice * registration.seats.size();
+    payment.paymentDate = now;
+    payment.paymentMethod = request.value("method", PaymentMethod::E_WALLET);
+    payment.paymentStatus = PaymentStatus::COMPLETED;
+    dm.saveRecord(payment, dm.paymentFileName);
+
+    registration.registrationStatus = RegistrationStatus::COMPLETED;
+    for (auto& seat : registration.seats) {
+        seat.status = SeatStatus::RESERVED;
+        if (seat.registrationId.empty()) seat.registrationId = registration.registrationId;
+    }
+    dm.saveRecord(registration, dm.registrationFileName);
+    adjustAvailableSeats(registration.eventId, -static_cast<int>(registration.seats.size()));
+
+    return { {"paymentId", payment.paymentId}, {"amount", payment.amount} };
+}
+
+nlohmann::json RequestEngine::vote(const nlohmann::json& request, time_t now, std::unique_lock<DataManager::StoreMutex>& storeLock) {
+    Registration registration = activeRegistration(request);
+    if (registration.registrationStatus != RegistrationStatus::COMPLETED || isRefunded(registration.registrationId)) {
+        throw std::runtime_error("Registration " + registration.registrationId + " is not paid.");
+    }
+
+    Event event = dm.getEventFromEventId(registration.eventId);
+    if (event.status == EventStatus::CANCELLED || now < event.startTime || now > event.endTime) {
+        throw std::runtime_error("Voting is only open while event " + event.eventId + " is ongoing.");
+    }
+
+    std::string songId = request.value("songId", "");
+    bool songInEvent = false;
+    for (const auto& performance : dm.loadDataWhere<Performance>(dm.performanceFileName, "eventId", event.eventId)) {
+        for (const auto& song : performance.songs) {
+            songInEvent = songInEvent || (!performance.isDeleted && song.songId == songId);
+        }
+    }
+    if (!songInEvent) {
+        throw std::runtime_error("Song " + songId + " is not performed at event " + event.eventId + ".");
+    }
+
+    Vote vote;
+    vote.songId = songId;
+    vote.registrationId = registration.registrationId;
+    vote.voteWeight = 1;
+    vote.voteTime = now;
+    if (ingestor) {
+        // The ingestor commits under the store lock, so let go of it while
+        // the vote's group is written.
+        storeLock.unlock();
+        VoteIngestor::Ack ack = ingestor->submit(vote).get();
+        storeLock.lock();
+        if (!ack.accepted) {
+            throw std::runtime_error(ack.error);
+        }
+        vote.voteId = ack.voteId;
+    }
+    else {
+        std::string error;
+        if (!dm.castVote(vote, error)) {
+            throw std::runtime_error(error);
+        }
+    }
+
+    return { {"voteId", vote.voteId}, {"remainingVotes", dm.getVoteQuota(registration.registrationId).remaining()} };
+}
+
+nlohmann::json RequestEngine::checkIn(const nlohmann::json& request, time_t now) {
+    Registration registration = activeRegistration(request);
+    Event event = dm.getEventFromEventId(registration.eventId);
+    if (now > event.endTime) {
+        throw std::runtime_error("Event " + event.eventId + " has already ended.");
+    }
+
+    std::vector<Attendance> attendances = dm.getAttendancesForRegistration(registration.registrationId);
+    for (const auto& attendance : attendances) {
+        if (attendance.attendanceStatus == AttendanceStatus::PRESENT) {
+            throw std::runtime_error("Registration " + registration.registrationId + " is already checked in.");
+        }
+    }
+
+    if (registration.registrationStatus != RegistrationStatus::COMPLETED) {
+        registration.registrationStatus = RegistrationStatus::COMPLETED;
+        dm.saveRecord(registration, dm.registrationFileName);
+    }
+
+    Attendance attendance;
+    if (!attendances.empty()) {
+        attendance = attendances.front();
+    }
+    else {
+        attendance.attendanceId = dm.generateNewAttendanceId();
+        attendance.registrationId = registration.registrationId;
+        attendance.attendanceTime = now;
+    }
+    attendance.attendanceStatus = AttendanceStatus::PRESENT;
+    dm.saveRecord(attendance, dm.attendanceFileName);
+
+    return { {"attendanceId", attendance.attendanceId} };
+}
+
+nlohmann::json RequestEngine::cancel(const nlohmann::json& request, time_t now) {
+    Registration registration = activeRegistration(request);
+    Event event = dm.getEventFromEventId(registration.eventId);
+
+    nlohmann::json result = { {"registrationId", registration.registrationId} };
+    for (auto payment : dm.getPaymentsForRegistration(registration.registrationId)) {
+        if (payment.paymentStatus != PaymentStatus::COMPLETED) {
+            continue;
+        }
+        if (now >= event.startTime - 2 * 60 * 60) {
+            throw std::runtime_error("Refund not allowed. Event starts within 2 hours or has already started.");
+        }
+
+        Refund refund;
+        refund.refundId = dm.generateNewRefundId();
+        refund.paymentId = payment.paymentId;
+        refund.refundAmount = payment.amount * 0.8;
+        refund.refundDate = now;
+        refund.reason = request.value("reason", "Cancelled by request.");
+        payment.paymentStatus = PaymentStatus::REFUNDED;
+
+        dm.saveRecord(refund, dm.refundFileName);
+        dm.saveRecord(payment, dm.paymentFileName);
+        adjustAvailableSeats(registration.eventId, static_cast<int>(registration.seats.size()));
+        result["refundId"] = refund.refundId;
+        result["refundAmount"] = refund.refundAmount;
+    }
+
+    for (auto& seat : registration.seats) {
+        seat.status = SeatStatus::AVAILABLE;
+        seat.registrationId.clear();
+    }
+    registration.registrationStatus = RegistrationStatus::CANCELLED;
+    dm.saveRecord(registration, dm.registrationFileName);
+
+    return result;
+}
+
+Event RequestEngine::requestedEvent(const nlohmann::json& request) {
+    std::string eventId = request.value("eventId", "");
+    Event event = dm.getEventFromEventId(eventId);
+    if (event.eventId.empty() || event.isDeleted) {
+        throw std::runtime_error("Event " + eventId + " not found.");
+    }
+    return event;
+}
+
+nlohmann::json RequestEngine::availability(const nlohmann::json& request) {
+    Event event = requestedEvent(request);
+    const SeatMap& seatMap = dm.getSeatMapForEvent(event.eventId);
+    const VenueLayout& layout = seatMap.layout();
+
+    nlohmann::json sections = nlohmann::json::array();
+    for (size_t i = 0; i < layout.sectionCount(); ++i) {
+        const VenueSection& section = layout.section(i);
+        sections.push_back({ {"name", section.name}, {"capacity", section.rows * section.seatsPerRow},
+            {"available", seatMap.availableInSection(i)} });
+    }
+    return { {"eventId", event.eventId}, {"capacity", seatMap.capacity()},
+        {"available", seatMap.capacity() - seatMap.occupiedCount()}, {"sections", sections} };
+}
+
+nlohmann::json RequestEngine::sales(const nlohmann::json& request) {
+    Event event = requestedEvent(request);
+    int paid = 0;
+    int refunded = 0;
+    double totalSales = 0;
+    // Refunded registrations are cancelled, so payments are taken from every
+    // registration of the event; only completed ones count as sales.
+    for (const auto& payment : dm.getPaymentsForEvent(event.eventId)) {
+        if (payment.isDeleted) continue;
+        if (payment.paymentStatus == PaymentStatus::COMPLETED) {
+            paid++;
+            totalSales += payment.amount;
+        }
+        else if (payment.paymentStatus == PaymentStatus::REFUNDED) {
+            refunded++;
+        }
+    }
+    return { {"eventId", event.eventId}, {"payments", paid}, {"refunds", refunded}, {"totalSales", totalSales} };
+}
+
+// Answered from the vote counters without the store lock. Events without
+// votes, or counters still being built, go through the store so unknown
+// events are reported.
+nlohmann::json RequestEngine::voteCounts(const nlohmann::json& request, std::unique_lock<DataManager::StoreMutex>& storeLock) {
+    std::string eventId = request.value("eventId", "");
+    const SongCounters& counters = DataManager::getVoteCounters();
+    std::vector<SongCounters::Count> songs;
+    if (!counters.snapshot(eventId, songs) || songs.empty()) {
+        storeLock.lock();
+        eventId = requestedEvent(request).eventId;
+        dm.getVoteTally();
+        counters.snapshot(eventId, songs);
+    }
+
+    int totalVotes = 0;
+    int totalWeight = 0;
+    for (const auto& song : songs) {
+        totalVotes += song.votes;
+        totalWeight += song.weight;
+    }
+    size_t keep = songs.size() < VoteTally::TOP_K ? songs.size() : VoteTally::TOP_K;
+    std::partial_sort(songs.begin(), songs.begin() + keep, songs.end(),
+        [](const SongCounters::Count& a, const SongCounters::Count& b) {
+            return a.weight != b.weight ? a.weight > b.weight : a.songId < b.songId;
+        });
+
+    nlohmann::json top = nlohmann::json::array();
+    for (size_t i = 0; i < keep; ++i) {
+        top.push_back({ {"songId", songs[i].songId}, {"votes", songs[i].votes}, {"weight", songs[i].weight} });
+    }
+    return { {"eventId", eventId}, {"totalVotes", totalVotes}, {"totalWeight", totalWeight}, {"top", top} };
+}
+
+nlohmann::json RequestEngine::trending(const nlohmann::json& request, time_t now) {
+    Event event = requestedEvent(request);
+    const TrendingSongs& trends = dm.getTrendingSongs();
+
+    nlohmann::json windows = nlohmann::json::array();
+    for (int minutes : { 1, 5, 15 }) {
+        nlohmann::json songs = nlohmann::json::array();
+        for (const auto& trend : trends.trending(event.eventId, minutes, now, TRENDING_LIMIT)) {
+            songs.push_back({ {"songId", trend.songId}, {"weight", trend.weight} });
+        }
+        windows.push_back({ {"minutes", minutes}, {"songs", songs} });
+    }
+    return { {"eventId", event.eventId}, {"windows", windows} };
+}
+
+// One event, a list of events counted together, or every event.
+nlohmann::json RequestEngine::audience(const nlohmann::json& request) {
+    const AudienceCounts& counts = dm.getAudienceCounts();
+    if (request.contains("eventIds")) {
+        std::vector<std::string> eventIds = request.at("eventIds").get<std::vector<std::string>>();
+        return { {"eventIds", eventIds}, {"uniqueVoters", counts.uniqueVoters(eventIds)},
+            {"uniqueAttendees", counts.uniqueAttendees(eventIds)} };
+    }
+    std::string eventId = request.contains("eventId") ? requestedEvent(request).eventId : AudienceCounts::ALL_EVENTS;
+    return { {"eventId", eventId}, {"uniqueVoters", counts.uniqueVoters(eventId)},
+        {"uniqueAttendees", counts.uniqueAttendees(eventId)} };
+}
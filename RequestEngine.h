@@ -0,0 +1,99 @@
+#pragma once
+#include <string>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "Model.h"
+#include "DataManager.h"
+
+class VoteIngestor;
+
+// Executes booking commands without the console menus. Each request is a JSON
+// object with an "op" field; the reply echoes its "id" and carries "ok" plus
+// either the result fields or an "error" message.
+//
+//   {"id":1,"op":"book","customerId":"CUS001","eventId":"EV001","seatCount":2}
+//   {"id":2,"op":"book","customerId":"CUS001","eventId":"EV001","seats":["R1C1"]}
+//   {"id":3,"op":"book","bookings":[{...}, {...}]}          all or nothing
+//   {"id":4,"op":"pay","registrationId":"REG001","method":"E_WALLET"}
+//   {"id":5,"op":"vote","registrationId":"REG001","songId":"SNG0001"}
+//   {"id":6,"op":"checkin","registrationId":"REG001"}
+//   {"id":7,"op":"cancel","registrationId":"REG001","reason":"..."}
+//   {"id":8,"op":"availability","eventId":"EV001"}      seats left per section
+//   {"id":9,"op":"sales","eventId":"EV001"}             payments and refunds
+//   {"id":10,"op":"votes","eventId":"EV001"}            leading songs
+//   {"id":11,"op":"trending","eventId":"EV001"}         most voted in the last 1/5/15 min
+//   {"id":12,"op":"audience","eventId":"EV001"}         distinct voters and attendees
+//
+// handle() may be called from several threads. Requests for one event run
+// one at a time under that event's lock; requests that span several events,
+// or whose event cannot be told, run alone. Their in-memory work runs under
+// DataManager::storeMutex(), which is let go while they wait on files or
+// write a journal, so requests for different events overlap their disk
+// writes. "votes" reads the lock-free vote counters instead. Requests naming
+// a registration may also carry its "eventId" to save the shard lookup.
+//
+// A "time" field (seconds since the epoch) overrides the current time, so a
+// recorded request file replays the same way later.
+//
+// With a VoteIngestor attached, votes are checked here and committed in
+// groups by the ingestor; the request waits for its group without holding
+// the store lock.
+class RequestEngine {
+public:
+    explicit RequestEngine(DataManager& dm);
+
+    void setVoteIngestor(VoteIngestor* ingestor) { this->ingestor = ingestor; }
+
+    nlohmann::json handle(const nlohmann::json& request);
+    // Parses one line and returns the reply line; malformed lines get an
+    // error reply instead of stopping the stream.
+    std::string handleLine(const std::string& line);
+
+    // The event a request works on, used to pick its executor shard. Empty
+    // when it cannot be told yet, e.g. paying for a registration that an
+    // earlier, still queued request creates, or when the request spans
+    // several events.
+    std::string shardKey(const nlohmann::json& request);
+    // Cancels registrations whose seat hold ran out before now. Runs alone,
+    // like a request spanning several events; returns how many were freed.
+    size_t expireSeatHolds(time_t now);
+
+    // True when shardKey() has to look the request's registration up in the
+    // store, i.e. it names a registration but no event.
+    static bool keyedByRegistration(const nlohmann::json& request);
+
+private:
+    static const size_t TRENDING_LIMIT = 5;
+
+    DataManager& dm;
+    VoteIngestor* ingestor = nullptr;
+
+    // Held shared by single-event requests and exclusively by the rest.
+    std::shared_mutex exclusiveGate;
+    std::mutex eventLocksMutex;
+    std::unordered_map<std::string, std::unique_ptr<std::mutex>> eventLocks;
+
+    std::mutex& eventLock(const std::string& eventId);
+
+    nlohmann::json book(const nlohmann::json& request, time_t now);
+    nlohmann::json pay(const nlohmann::json& request, time_t now);
+    nlohmann::json vote(const nlohmann::json& request, time_t now, std::unique_lock<DataManager::StoreMutex>& storeLock);
+    nlohmann::json checkIn(const nlohmann::json& request, time_t now);
+    nlohmann::json cancel(const nlohmann::json& request, time_t now);
+    nlohmann::json availability(const nlohmann::json& request);
+    nlohmann::json sales(const nlohmann::json& request);
+    nlohmann::json voteCounts(const nlohmann::json& request, std::unique_lock<DataManager::StoreMutex>& storeLock);
+    nlohmann::json trending(const nlohmann::json& request, time_t now);
+    nlohmann::json audience(const nlohmann::json& request);
+
+    Event requestedEvent(const nlohmann::json& request);
+    Registration activeRegistration(const nlohmann::json& request);
+    bool isRefunded(const std::string& registrationId);
+    void adjustAvailableSeats(const std::string& eventId, int change);
+    static DataManager::BookingRequest bookingFrom(const nlohmann::json& booking);
+    static nlohmann::json describe(const Registration& registration);
+};
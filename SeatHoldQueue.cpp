@@ -0,0 +1,19 @@
+#include "SeatHoldQueue.h"
+
+void SeatHoldQueue::add(const std::string& registrationId, time_t registerTime) {
+    holds.push({ registerTime + HOLD_TTL, registrationId });
+}
+
+std::vector<SeatHoldQueue::Hold> SeatHoldQueue::takeExpired(time_t now) {
+    std::vector<Hold> expired;
+    while (!holds.empty() && holds.top().expiresAt < now) {
+        expired.push_back(holds.top());
+        holds.pop();
+    }
+    return expired;
+}
+
+void SeatHoldQueue::clear() {
+    holds = {};
+    loaded = false;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <ctime>
+#include <queue>
+#include <string>
+#include <vector>
+
+// Unpaid registrations hold their seats until an expiry time. Holds sit in a
+// min-heap keyed by that time, so finding the due ones costs O(log n) each.
+// A hold is not removed when its registration is paid or cancelled; the
+// caller skips it when it comes due.
+class SeatHoldQueue {
+public:
+    // Matches Validation::validateUnpaidRegistration.
+    static const time_t HOLD_TTL = 24 * 60 * 60;
+
+    struct Hold {
+        time_t expiresAt;
+        std::string registrationId;
+
+        bool operator>(const Hold& other) const {
+            return expiresAt > other.expiresAt;
+        }
+    };
+
+    bool isLoaded() const { return loaded; }
+    void markLoaded() { loaded = true; }
+    size_t size() const { return holds.size(); }
+
+    void add(const std::string& registrationId, time_t registerTime);
+    // Removes and returns the holds that expired before now, earliest first.
+    std::vector<Hold> takeExpired(time_t now);
+    void clear();
+
+private:
+    bool loaded = false;
+    std::priority_queue<Hold, std::vector<Hold>, std::greater<Hold>> holds;
+};
@@ -0,0 +1,36 @@
+#include "SeatHoldReaper.h"
+#include <ctime>
+#include <iostream>
+
+SeatHoldReaper::SeatHoldReaper(RequestEngine& engine, ShardedExecutor& executor, std::chrono::seconds interval)
+    : engine(engine), executor(executor), interval(interval) {
+    timer = std::thread([this] { run(); });
+}
+
+SeatHoldReaper::~SeatHoldReaper() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    stopped.notify_one();
+    timer.join();
+}
+
+void SeatHoldReaper::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopped.wait_for(lock, interval, [this] { return stopping; })) {
+        if (lastPass.valid()) {
+            if (lastPass.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                continue;
+            }
+            try {
+                lastPass.get();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Releasing expired seat holds failed: " << e.what() << "\n";
+            }
+        }
+        RequestEngine& handler = engine;
+        lastPass = executor.submit("", [&handler] { return handler.expireSeatHolds(time(nullptr)); });
+    }
+}
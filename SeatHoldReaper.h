@@ -0,0 +1,38 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "RequestEngine.h"
+#include "ShardedExecutor.h"
+
+// Releases abandoned seat holds while a long-running process serves
+// requests. Every interval a timer thread queues one expiry pass on the
+// executor's unkeyed shard, where it runs alone like any request spanning
+// several events. A pass still running when the next one is due is not
+// doubled up, and a failed pass is reported on stderr and retried on the
+// next tick.
+//
+// Declare it after the executor, so it stops before the executor drains.
+class SeatHoldReaper {
+public:
+    SeatHoldReaper(RequestEngine& engine, ShardedExecutor& executor, std::chrono::seconds interval);
+    ~SeatHoldReaper();
+
+    SeatHoldReaper(const SeatHoldReaper&) = delete;
+    SeatHoldReaper& operator=(const SeatHoldReaper&) = delete;
+
+private:
+    RequestEngine& engine;
+    ShardedExecutor& executor;
+    const std::chrono::seconds interval;
+
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool stopping = false;
+    std::future<size_t> lastPass;
+    std::thread timer;
+
+    void run();
+};
@@ -0,0 +1,191 @@
+#include "SeatMap.h"
+#include <algorithm>
+#include <cstdlib>
+
+SeatMap::SeatMap(const VenueLayout& layout)
+    : venue(layout), sectionOccupied(layout.sectionCount(), 0), bits((layout.capacity() + 63) / 64, 0) {
+}
+
+bool SeatMap::testBit(int seat) const {
+    return seat >= 0 && (bits[seat / 64] >> (seat % 64) & 1) != 0;
+}
+
+int SeatMap::availableInSection(size_t section) const {
+    const VenueSection& info = venue.section(section);
+    return info.rows * info.seatsPerRow - sectionOccupied[section];
+}
+
+bool SeatMap::contains(int row, int column) const {
+    return venue.seatNumber(row, column) >= 0;
+}
+
+bool SeatMap::isOccupied(int row, int column) const {
+    return testBit(venue.seatNumber(row, column));
+}
+
+bool SeatMap::isOccupied(const std::string& row, const std::string& column) const {
+    return isOccupied(VenueLayout::parseNumber(row), VenueLayout::parseNumber(column));
+}
+
+bool SeatMap::occupy(int row, int column) {
+    int seat = venue.seatNumber(row, column);
+    if (seat < 0 || testBit(seat)) {
+        return false;
+    }
+    bits[seat / 64] |= uint64_t(1) << (seat % 64);
+    occupied++;
+    sectionOccupied[venue.sectionOfRow(row)]++;
+    return true;
+}
+
+bool SeatMap::release(int row, int column) {
+    int seat = venue.seatNumber(row, column);
+    if (seat < 0 || !testBit(seat)) {
+        return false;
+    }
+    bits[seat / 64] &= ~(uint64_t(1) << (seat % 64));
+    occupied--;
+    sectionOccupied[venue.sectionOfRow(row)]--;
+    return true;
+}
+
+bool SeatMap::occupy(const std::string& row, const std::string& column) {
+    return occupy(VenueLayout::parseNumber(row), VenueLayout::parseNumber(column));
+}
+
+bool SeatMap::release(const std::string& row, const std::string& column) {
+    return release(VenueLayout::parseNumber(row), VenueLayout::parseNumber(column));
+}
+
+// Finds the block of length free seats that is closest to the centre of rows
+// firstRow..lastRow, measured in rows first and then in seats from the middle
+// of the row. Rows are visited outwards from the centre, so the search stops
+// as soon as no further row can beat the best block found.
+bool SeatMap::bestBlock(int length, int firstRow, int lastRow, int& bestRow, int& bestColumn) const {
+    const double ROW_WEIGHT = 2.0;
+    double centreRow = (firstRow + lastRow) / 2.0;
+    double bestCost = -1;
+
+    for (int step = 0; step <= lastRow - firstRow; ++step) {
+        // Alternate below and above the centre: c, c+1, c-1, c+2, ...
+        int offset = (step + 1) / 2;
+        int row = static_cast<int>(centreRow) + (step % 2 == 1 ? offset : -offset);
+        if (row < firstRow || row > lastRow) {
+            continue;
+        }
+        double rowCost = std::abs(row - centreRow) * ROW_WEIGHT;
+        if (bestCost >= 0 && rowCost > bestCost) {
+            break;
+        }
+
+        int width = venue.seatsInRow(row);
+        if (width < length) {
+            continue;
+        }
+        int first = venue.seatNumber(row, 1);
+        double middle = (width - length) / 2.0;
+
+        // Walk the free runs of the row; within a run the block sits as close
+        // to the middle of the row as the run allows.
+        int column = 0;
+        while (column < width) {
+            while (column < width && testBit(first + column)) {
+                ++column;
+            }
+            int runStart = column;
+            while (column < width && !testBit(first + column)) {
+                ++column;
+            }
+            int runLength = column - runStart;
+            if (runLength < length) {
+                continue;
+            }
+            int start = std::min(std::max(static_cast<int>(middle + 0.5), runStart), column - length);
+            double cost = rowCost + std::abs(start - middle);
+            if (bestCost < 0 || cost < bestCost) {
+                bestCost = cost;
+                bestRow = row;
+                bestColumn = start + 1;
+            }
+        }
+    }
+    return bestCost >= 0;
+}
+
+int SeatMap::longestFreeRun(int firstRow, int lastRow) const {
+    int longest = 0;
+    for (int row = firstRow; row <= lastRow; ++row) {
+        int first = venue.seatNumber(row, 1);
+        int width = venue.seatsInRow(row);
+        int run = 0;
+        for (int column = 0; column < width; ++column) {
+            run = testBit(first + column) ? 0 : run + 1;
+            longest = std::max(longest, run);
+        }
+    }
+    return longest;
+}
+
+std::vector<std::pair<int, int>> SeatMap::bestAvailable(int count, int section) const {
+    std::vector<std::pair<int, int>> seats;
+    if (count <= 0 || venue.sectionCount() == 0) {
+        return seats;
+    }
+
+    int firstRow = 1;
+    int lastRow = venue.rowCount();
+    int free = capacity() - occupied;
+    if (section >= 0) {
+        firstRow = venue.firstRow(section);
+        lastRow = venue.lastRow(section);
+        free = availableInSection(section);
+    }
+    if (count > free) {
+        return seats;
+    }
+
+    // Claimed seats are marked on a copy so later blocks avoid them.
+    SeatMap working = *this;
+    int remaining = count;
+    while (remaining > 0) {
+        // Try the whole remainder first; only a miss needs the full scan for
+        // the longest run.
+        int length = remaining;
+        int row = 0;
+        int column = 0;
+        if (!working.bestBlock(length, firstRow, lastRow, row, column)) {
+            length = std::min(remaining, working.longestFreeRun(firstRow, lastRow));
+            if (length <= 0 || !working.bestBlock(length, firstRow, lastRow, row, column)) {
+                break;
+            }
+        }
+        for (int i = 0; i < length; ++i) {
+            working.occupy(row, column + i);
+            seats.emplace_back(row, column + i);
+        }
+        remaining -= length;
+    }
+    return seats;
+}
+
+std::vector<std::vector<bool>> SeatMap::toGrid(int firstRow, int lastRow) const {
+    std::vector<std::vector<bool>> grid;
+    for (int row = std::max(firstRow, 1); row <= std::min(lastRow, venue.rowCount()); ++row) {
+        int width = venue.seatsInRow(row);
+        int first = venue.seatNumber(row, 1);
+        std::vector<bool> seats(width, false);
+        for (int column = 0; column < width; ++column) {
+            seats[column] = testBit(first + column);
+        }
+        grid.push_back(std::move(seats));
+    }
+    // printSeatingChart needs at least one row to draw the column header.
+    if (grid.empty()) {
+        grid.push_back(std::vector<bool>(VenueLayout::DEFAULT_SEATS_PER_ROW, false));
+    }
+    return grid;
+}
+
+std::vector<std::vector<bool>> SeatMap::toGrid() const {
+    return toGrid(1, venue.rowCount());
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "VenueLayout.h"
+
+// Occupancy of an event's seats, one bit per seat plus a running count per
+// section. Rows and columns are 1-based to match Seat::row and Seat::column.
+class SeatMap {
+public:
+    SeatMap() = default;
+    explicit SeatMap(const VenueLayout& layout);
+
+    const VenueLayout& layout() const { return venue; }
+    int capacity() const { return venue.capacity(); }
+    int occupiedCount() const { return occupied; }
+    int occupiedInSection(size_t section) const { return sectionOccupied[section]; }
+    int availableInSection(size_t section) const;
+
+    bool contains(int row, int column) const;
+    bool isOccupied(int row, int column) const;
+    bool isOccupied(const std::string& row, const std::string& column) const;
+
+    // Both return false when the seat is outside the venue or already in that state.
+    bool occupy(int row, int column);
+    bool release(int row, int column);
+    bool occupy(const std::string& row, const std::string& column);
+    bool release(const std::string& row, const std::string& column);
+
+    // Best free seats for a party of count as (row, column) pairs, or empty when
+    // too few seats are free. A single block in one row is preferred, closest
+    // to the centre row and then to the middle of its row; larger parties are
+    // split into the biggest blocks that fit. section < 0 searches the venue.
+    std::vector<std::pair<int, int>> bestAvailable(int count, int section = -1) const;
+
+    // Rows firstRow..lastRow as expected by OutputManager::printSeatingChart;
+    // each row is as wide as its section.
+    std::vector<std::vector<bool>> toGrid(int firstRow, int lastRow) const;
+    std::vector<std::vector<bool>> toGrid() const;
+
+private:
+    VenueLayout venue;
+    int occupied = 0;
+    std::vector<int> sectionOccupied;
+    std::vector<uint64_t> bits;
+
+    bool testBit(int seat) const;
+    bool bestBlock(int length, int firstRow, int lastRow, int& bestRow, int& bestColumn) const;
+    int longestFreeRun(int firstRow, int lastRow) const;
+};
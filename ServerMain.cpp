@@ -0,0 +1,71 @@
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "DataManager.h"
+#include "RequestEngine.h"
+#include "ShardedExecutor.h"
+#include "VoteIngestor.h"
+#include "SeatHoldReaper.h"
+#include "HttpServer.h"
+
+// Serves the booking operations over HTTP on 127.0.0.1 until Ctrl+C.
+//   BookingServer [--port 8080] [--threads N]
+
+// Unpaid holds are released this often while the server runs.
+static const std::chrono::seconds HOLD_REAP_INTERVAL(60);
+
+static HttpServer* activeServer = nullptr;
+
+static void stopServer(int) {
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    unsigned short port = 8080;
+    size_t threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = static_cast<unsigned short>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<size_t>(std::atoi(argv[++i]));
+        }
+        else {
+            std::cerr << "Usage: BookingServer [--port 8080] [--threads N]\n";
+            return 1;
+        }
+    }
+
+    try {
+        DataManager dm;
+        dm.expireSeatHolds(time(nullptr));
+        RequestEngine engine(dm);
+        // Each worker waits for its vote's ack, so at most one vote per worker
+        // is queued and holding a group open would only stall them: groups
+        // are the votes that arrive while the previous one is written.
+        // Declared before the executor so it outlives the jobs waiting on it.
+        VoteIngestor ingestor(dm, threads, std::chrono::milliseconds(0));
+        engine.setVoteIngestor(&ingestor);
+        ShardedExecutor executor(threads);
+        SeatHoldReaper reaper(engine, executor, HOLD_REAP_INTERVAL);
+        HttpServer server(engine, executor);
+        server.listen(port);
+
+        activeServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        std::cout << "Listening on http://127.0.0.1:" << port << " with " << executor.shardCount() << " worker threads.\n";
+        server.run();
+        activeServer = nullptr;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "ShardedExecutor.h"
+
+ShardedExecutor::ShardedExecutor(size_t shardCount) {
+    if (shardCount == 0) {
+        shardCount = 1;
+    }
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+    for (auto& shard : shards) {
+        Shard& target = *shard;
+        shard->worker = std::thread([&target] { work(target); });
+    }
+}
+
+ShardedExecutor::~ShardedExecutor() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->stopping = true;
+        shard->ready.notify_one();
+    }
+    for (auto& shard : shards) {
+        shard->worker.join();
+    }
+}
+
+size_t ShardedExecutor::shardOf(const std::string& key) const {
+    return std::hash<std::string>()(key) % shards.size();
+}
+
+void ShardedExecutor::enqueue(size_t shard, std::function<void()> job) {
+    Shard& target = *shards[shard];
+    {
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.jobs.push_back(std::move(job));
+    }
+    target.ready.notify_one();
+}
+
+void ShardedExecutor::work(Shard& shard) {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.ready.wait(lock, [&shard] { return shard.stopping || !shard.jobs.empty(); });
+            if (shard.jobs.empty()) {
+                return;
+            }
+            job = std::move(shard.jobs.front());
+            shard.jobs.pop_front();
+        }
+        // Exceptions reach the caller through the job's future.
+        job();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs jobs on a fixed set of worker threads. Every job carries a key (an
+// event id) and jobs with the same key always land on the same shard, so
+// they run one at a time in submission order while other keys run in
+// parallel. The destructor finishes all queued jobs before joining.
+class ShardedExecutor {
+public:
+    explicit ShardedExecutor(size_t shardCount);
+    ~ShardedExecutor();
+
+    ShardedExecutor(const ShardedExecutor&) = delete;
+    ShardedExecutor& operator=(const ShardedExecutor&) = delete;
+
+    size_t shardCount() const { return shards.size(); }
+    size_t shardOf(const std::string& key) const;
+
+    template <typename F>
+    auto submit(const std::string& key, F task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto job = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> result = job->get_future();
+        enqueue(shardOf(key), [job] { (*job)(); });
+        return result;
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<std::function<void()>> jobs;
+        bool stopping = false;
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    void enqueue(size_t shard, std::function<void()> job);
+    static void work(Shard& shard);
+};
@@ -0,0 +1,83 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include "Model.h"
+#include "BinarySnapshot.h"
+#include "FileUtils.h"
+#include "JsonRecordStream.h"
+
+// Converts entity snapshots between the JSON and binary formats.
+//   SnapshotConverter to-binary registrations registrations.json registrations.bin
+//   SnapshotConverter to-json registrations registrations.bin registrations.json
+
+template <typename T>
+std::string convertSnapshot(const std::string& contents, bool toBinary) {
+    if (toBinary) {
+        if (BinarySnapshot::isBinarySnapshot(contents)) {
+            BinarySnapshot::decode<T>(contents);
+            return contents;
+        }
+        std::vector<T> rows;
+        if (contents.find_first_not_of(" \t\r\n") != std::string::npos) {
+            JsonStream::forEachRecord<T>(contents, [&](T&& record) { rows.push_back(std::move(record)); });
+        }
+        return BinarySnapshot::encode(rows);
+    }
+
+    nlohmann::json j = BinarySnapshot::decode<T>(contents);
+    return j.dump(4);
+}
+
+std::string convertEntity(const std::string& entity, const std::string& contents, bool toBinary) {
+    if (entity == "users") return convertSnapshot<User>(contents, toBinary);
+    if (entity == "events") return convertSnapshot<Event>(contents, toBinary);
+    if (entity == "registrations") return convertSnapshot<Registration>(contents, toBinary);
+    if (entity == "payments") return convertSnapshot<Payment>(contents, toBinary);
+    if (entity == "refunds") return convertSnapshot<Refund>(contents, toBinary);
+    if (entity == "performances") return convertSnapshot<Performance>(contents, toBinary);
+    if (entity == "votes") return convertSnapshot<Vote>(contents, toBinary);
+    if (entity == "attendances") return convertSnapshot<Attendance>(contents, toBinary);
+    throw std::invalid_argument("Unknown entity " + entity + ".");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 5) {
+        std::cerr << "Usage: SnapshotConverter <to-binary|to-json> <entity> <input> <output>\n";
+        std::cerr << "Entities: users, events, registrations, payments, refunds, performances, votes, attendances\n";
+        return 1;
+    }
+
+    std::string direction = argv[1];
+    std::string entity = argv[2];
+    std::string input = argv[3];
+    std::string output = argv[4];
+
+    if (direction != "to-binary" && direction != "to-json") {
+        std::cerr << "Unknown direction " << direction << ".\n";
+        return 1;
+    }
+
+    try {
+        std::string contents;
+        if (!FileManagement::readFile(input, contents)) {
+            throw std::runtime_error("Unable to open " + input + ".");
+        }
+        if (!FileManagement::verifyChecksum(input, contents)) {
+            throw std::runtime_error(input + " failed its checksum.");
+        }
+
+        std::string converted = convertEntity(entity, contents, direction == "to-binary");
+        if (!FileManagement::writeFileWithChecksum(output, converted)) {
+            throw std::runtime_error("Unable to write " + output + ".");
+        }
+        std::cout << "Converted " << input << " (" << contents.size() << " bytes) to "
+            << output << " (" << converted.size() << " bytes).\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
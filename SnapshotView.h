@@ -0,0 +1,131 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "BinarySnapshot.h"
+#include "FileUtils.h"
+
+template <typename T, typename = void>
+struct HasSoftDelete : std::false_type {};
+template <typename T>
+struct HasSoftDelete<T, std::void_t<decltype(&T::isDeleted)>> : std::true_type {};
+
+template <typename T>
+class SnapshotView;
+
+// A single row of a SnapshotView. Valid while the view it came from is alive.
+template <typename T>
+class RecordView {
+public:
+    RecordView(const SnapshotView<T>* view, size_t row) : view(view), row(row) {
+    }
+
+    std::string_view text(std::string T::* field) const {
+        if (view->rows) {
+            return (*view->rows)[row].*field;
+        }
+        return view->table.text(row, field);
+    }
+
+    template <typename F>
+    F get(F T::* field) const {
+        if (view->rows) {
+            return (*view->rows)[row].*field;
+        }
+        return view->table.value(row, field);
+    }
+
+    template <typename U>
+    SnapshotView<U> list(std::vector<U> T::* field) const {
+        if (view->rows) {
+            return SnapshotView<U>((*view->rows)[row].*field);
+        }
+        return SnapshotView<U>(view->file, view->table.list(row, field));
+    }
+
+private:
+    const SnapshotView<T>* view;
+    size_t row;
+};
+
+// Read-only rows of an entity file without a private copy: either the resident
+// rows of the store or a memory-mapped binary snapshot read in place.
+// Soft-deleted records are skipped. A resident view is invalidated by the next
+// write to the same file, and on Windows a mapped file cannot be replaced while
+// it is mapped, so keep views for the duration of a report only.
+template <typename T>
+class SnapshotView {
+public:
+    class Iterator {
+    public:
+        Iterator(const SnapshotView* view, size_t index) : view(view), index(index) {
+        }
+        RecordView<T> operator*() const {
+            return (*view)[index];
+        }
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const {
+            return index != other.index;
+        }
+
+    private:
+        const SnapshotView* view;
+        size_t index;
+    };
+
+    SnapshotView() = default;
+
+    explicit SnapshotView(const std::vector<T>& residentRows) : rows(&residentRows) {
+        selectActiveRows(residentRows.size());
+    }
+
+    SnapshotView(std::shared_ptr<const FileManagement::MappedFile> mappedFile, BinarySnapshot::TableView<T> mappedTable)
+        : file(std::move(mappedFile)), table(std::move(mappedTable)) {
+        selectActiveRows(table.size());
+    }
+
+    size_t size() const {
+        return active.size();
+    }
+
+    bool empty() const {
+        return active.empty();
+    }
+
+    RecordView<T> operator[](size_t index) const {
+        return RecordView<T>(this, active[index]);
+    }
+
+    Iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() const {
+        return Iterator(this, active.size());
+    }
+
+private:
+    friend class RecordView<T>;
+
+    const std::vector<T>* rows = nullptr;
+    std::shared_ptr<const FileManagement::MappedFile> file;
+    BinarySnapshot::TableView<T> table;
+    std::vector<size_t> active;
+
+    void selectActiveRows(size_t rowCount) {
+        active.reserve(rowCount);
+        for (size_t row = 0; row < rowCount; ++row) {
+            if constexpr (HasSoftDelete<T>::value) {
+                if (RecordView<T>(this, row).get(&T::isDeleted)) {
+                    continue;
+                }
+            }
+            active.push_back(row);
+        }
+    }
+};
@@ -0,0 +1,51 @@
+#include "SnowflakeId.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include "FileUtils.h"
+
+static std::string nodeLockFileName(int node) {
+    return "node_" + std::to_string(node) + ".lock";
+}
+
+int SnowflakeId::nodeId() {
+    static FileManagement::FileLock lease;
+    static const int node = [] {
+        for (int candidate = 0; candidate < MAX_NODES; ++candidate) {
+            if (lease.tryLock(nodeLockFileName(candidate))) {
+                return candidate;
+            }
+        }
+        throw std::runtime_error("No free node id for SnowflakeId");
+    }();
+    return node;
+}
+
+long long SnowflakeId::currentMillis() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count() - EPOCH_MS;
+}
+
+// Packed (millis << SEQUENCE_BITS | sequence) of the last ID handed out.
+std::atomic<long long>& SnowflakeId::state() {
+    static std::atomic<long long> last(0);
+    return last;
+}
+
+long long SnowflakeId::next() {
+    const long long node = nodeId();
+    std::atomic<long long>& last = state();
+
+    // Take the current millisecond, or the successor of the last ID when the
+    // clock has not moved (or went backwards). A full sequence carries into
+    // the next millisecond, so IDs stay strictly increasing per process.
+    long long previous = last.load(std::memory_order_relaxed);
+    long long claimed;
+    do {
+        claimed = std::max(currentMillis() << SEQUENCE_BITS, previous + 1);
+    } while (!last.compare_exchange_weak(previous, claimed, std::memory_order_relaxed));
+
+    const long long sequenceMask = (1LL << SEQUENCE_BITS) - 1;
+    long long millis = claimed >> SEQUENCE_BITS;
+    return (millis << (NODE_BITS + SEQUENCE_BITS)) | (node << SEQUENCE_BITS) | (claimed & sequenceMask);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+// 64-bit time-ordered IDs: 41 bits of milliseconds since EPOCH_MS, a 10-bit
+// node number and a 12-bit sequence. Each process leases its own node number
+// through a lock file, so IDs stay unique across threads and processes
+// without any shared counter on disk.
+class SnowflakeId {
+public:
+    static const long long EPOCH_MS = 1704067200000LL; // 2024-01-01T00:00:00Z
+    static const int NODE_BITS = 10;
+    static const int SEQUENCE_BITS = 12;
+    static const int MAX_NODES = 1 << NODE_BITS;
+
+    static long long next();
+    static std::string next(const std::string& prefix) {
+        return prefix + std::to_string(next());
+    }
+
+    // Node number leased by this process; throws std::runtime_error when all
+    // MAX_NODES lock files are held by other processes.
+    static int nodeId();
+
+private:
+    static long long currentMillis();
+    static std::atomic<long long>& state();
+};
@@ -0,0 +1,105 @@
+#include "SongCounters.h"
+#include <stdexcept>
+
+// Votes sit in the high half of a counter and weight in the low half.
+static const int64_t VOTE_UNIT = int64_t(1) << 32;
+
+SongCounters::SongCounters() {
+    for (auto& chunk : chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SongCounters::~SongCounters() {
+    for (auto& chunk : chunks) {
+        delete chunk.load(std::memory_order_relaxed);
+    }
+}
+
+SongCounters::Chunk& SongCounters::chunkOf(size_t slot) const {
+    return *chunks[slot / CHUNK_SIZE].load(std::memory_order_acquire);
+}
+
+size_t SongCounters::slot(const std::string& eventId, const std::string& songId) {
+    std::lock_guard<std::mutex> lock(slotsMutex);
+    std::string key = eventId + '\n' + songId;
+    auto it = slotsByKey.find(key);
+    if (it != slotsByKey.end()) {
+        return it->second;
+    }
+
+    size_t index = slotCount.load(std::memory_order_relaxed);
+    if (index == CHUNK_SIZE * MAX_CHUNKS) {
+        throw std::runtime_error("Too many songs to count votes for.");
+    }
+    if (index % CHUNK_SIZE == 0) {
+        chunks[index / CHUNK_SIZE].store(new Chunk(), std::memory_order_release);
+    }
+    Key& created = chunkOf(index).keys[index % CHUNK_SIZE];
+    created.eventId = eventId;
+    created.songId = songId;
+    // Readers only look at slots below slotCount, so the key is complete
+    // before they can reach it.
+    slotCount.store(index + 1, std::memory_order_release);
+    slotsByKey.emplace(std::move(key), index);
+    return index;
+}
+
+void SongCounters::add(size_t slot, int votes, int weight) {
+    int64_t delta = votes * VOTE_UNIT + weight;
+    chunkOf(slot).counters[slot % CHUNK_SIZE].counts.fetch_add(static_cast<uint64_t>(delta), std::memory_order_relaxed);
+}
+
+void SongCounters::reset() {
+    if (!resetting) {
+        resetting = true;
+        generation.fetch_add(1, std::memory_order_relaxed);
+        // Readers that see a zeroed counter must also see the odd generation.
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    size_t count = slotCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        chunkOf(i).counters[i % CHUNK_SIZE].counts.store(0, std::memory_order_relaxed);
+    }
+}
+
+void SongCounters::publish() {
+    if (resetting) {
+        resetting = false;
+        generation.fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool SongCounters::snapshot(const std::string& eventId, std::vector<Count>& counts) const {
+    for (;;) {
+        uint64_t before = generation.load(std::memory_order_acquire);
+        if (before % 2 == 1) {
+            return false;
+        }
+
+        counts.clear();
+        size_t count = slotCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const Chunk& chunk = chunkOf(i);
+            const Key& key = chunk.keys[i % CHUNK_SIZE];
+            if (key.eventId != eventId) {
+                continue;
+            }
+            uint64_t packed = chunk.counters[i % CHUNK_SIZE].counts.load(std::memory_order_relaxed);
+            if (packed == 0) {
+                continue;
+            }
+            Count song;
+            song.songId = key.songId;
+            song.votes = static_cast<int>(packed / VOTE_UNIT);
+            song.weight = static_cast<int>(packed % VOTE_UNIT);
+            counts.push_back(song);
+        }
+
+        // A rebuild that started while reading means start over.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (generation.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Vote and weight totals per (event, song), one counter per cache line so
+// threads bumping different songs never contend for the same line. A
+// counter keeps both totals in one 64-bit word, so an update is a single
+// fetch_add and a read always sees a vote and its weight together.
+//
+// Readers take no lock. Slots are only ever appended and their keys never
+// change once published; reset() and publish() bracket a rebuild like a
+// seqlock, so a snapshot never mixes totals from before and after one.
+class SongCounters {
+public:
+    struct Count {
+        std::string songId;
+        int votes = 0;
+        int weight = 0;
+    };
+
+    SongCounters();
+    ~SongCounters();
+
+    SongCounters(const SongCounters&) = delete;
+    SongCounters& operator=(const SongCounters&) = delete;
+
+    // Finds or creates the counter of the song at the event. Safe to call
+    // from several threads; the returned slot never moves.
+    size_t slot(const std::string& eventId, const std::string& songId);
+    // Lock-free; totals must never go below zero.
+    void add(size_t slot, int votes, int weight);
+
+    // Zeroes every counter until publish() marks the rebuilt totals
+    // readable. Calls must not overlap each other or add().
+    void reset();
+    void publish();
+
+    // Fills the songs of the event with at least one vote, in slot order.
+    // Returns false while the totals are being rebuilt or were never built.
+    bool snapshot(const std::string& eventId, std::vector<Count>& counts) const;
+
+private:
+    static const size_t CHUNK_SIZE = 256;
+    static const size_t MAX_CHUNKS = 1024;
+
+    // The keys are kept apart from the counters so a counter's line holds
+    // nothing else; readers matching keys never touch a line being written.
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> counts{ 0 };
+    };
+    struct Key {
+        std::string eventId;
+        std::string songId;
+    };
+    struct Chunk {
+        Counter counters[CHUNK_SIZE];
+        Key keys[CHUNK_SIZE];
+    };
+
+    std::atomic<Chunk*> chunks[MAX_CHUNKS];
+    alignas(64) std::atomic<size_t> slotCount{ 0 };
+    // Odd while a rebuild is under way; starts odd as nothing is built yet.
+    alignas(64) std::atomic<uint64_t> generation{ 1 };
+    bool resetting = true;
+
+    std::mutex slotsMutex;
+    std::unordered_map<std::string, size_t> slotsByKey;
+
+    Chunk& chunkOf(size_t slot) const;
+};
@@ -0,0 +1,118 @@
+#include "TrendingSongs.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+
+void TrendingSongs::clear() {
+    events.clear();
+    loaded = false;
+}
+
+// Each sketch row needs its own hash; mixing the song's hash with the row
+// number (splitmix64) gives independent-looking columns from one string hash.
+size_t TrendingSongs::column(size_t hash, size_t row) {
+    uint64_t x = static_cast<uint64_t>(hash) + (row + 1) * 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return row * SKETCH_WIDTH + static_cast<size_t>(x % SKETCH_WIDTH);
+}
+
+void TrendingSongs::Bucket::reset(long long newMinute) {
+    minute = newMinute;
+    sketch.fill(0);
+    heavy.clear();
+}
+
+void TrendingSongs::Bucket::add(const std::string& songId, size_t hash, int weight) {
+    // Conservative update: raise each row only as far as the new estimate,
+    // which keeps collisions from inflating the other rows.
+    int raised = estimate(hash) + weight;
+    for (size_t row = 0; row < SKETCH_DEPTH; ++row) {
+        int& cell = sketch[column(hash, row)];
+        cell = std::max(cell, raised);
+    }
+
+    // SpaceSaving: a song not in a full list takes the place of the lightest
+    // one and inherits its weight, which bounds how far it can overcount.
+    auto found = std::find_if(heavy.begin(), heavy.end(), [&](const HeavyHitter& h) { return h.songId == songId; });
+    if (found != heavy.end()) {
+        found->weight += weight;
+    }
+    else if (heavy.size() < HEAVY_HITTERS) {
+        heavy.push_back({ songId, weight });
+    }
+    else {
+        auto lightest = std::min_element(heavy.begin(), heavy.end(),
+            [](const HeavyHitter& a, const HeavyHitter& b) { return a.weight < b.weight; });
+        lightest->songId = songId;
+        lightest->weight += weight;
+    }
+}
+
+int TrendingSongs::Bucket::estimate(size_t hash) const {
+    int lowest = sketch[column(hash, 0)];
+    for (size_t row = 1; row < SKETCH_DEPTH; ++row) {
+        lowest = std::min(lowest, sketch[column(hash, row)]);
+    }
+    return lowest;
+}
+
+void TrendingSongs::add(const std::string& eventId, const std::string& songId, int weight, time_t voteTime) {
+    if (voteTime <= 0 || weight <= 0) {
+        return;
+    }
+    long long minute = static_cast<long long>(voteTime) / 60;
+    Bucket& bucket = events[eventId].buckets[minute % MAX_WINDOW_MINUTES];
+    if (bucket.minute > minute) {
+        return;
+    }
+    if (bucket.minute < minute) {
+        bucket.reset(minute);
+    }
+    bucket.add(songId, std::hash<std::string>()(songId), weight);
+}
+
+std::vector<TrendingSongs::Trend> TrendingSongs::trending(const std::string& eventId, int minutes, time_t now, size_t limit) const {
+    std::vector<Trend> trends;
+    auto found = events.find(eventId);
+    if (found == events.end() || now <= 0) {
+        return trends;
+    }
+    if (minutes > MAX_WINDOW_MINUTES) {
+        minutes = MAX_WINDOW_MINUTES;
+    }
+
+    long long lastMinute = static_cast<long long>(now) / 60;
+    std::vector<const Bucket*> window;
+    for (long long minute = std::max(0LL, lastMinute - minutes + 1); minute <= lastMinute; ++minute) {
+        const Bucket& bucket = found->second.buckets[minute % MAX_WINDOW_MINUTES];
+        if (bucket.minute == minute) {
+            window.push_back(&bucket);
+        }
+    }
+
+    std::unordered_set<std::string> candidates;
+    for (const Bucket* bucket : window) {
+        for (const auto& hitter : bucket->heavy) {
+            candidates.insert(hitter.songId);
+        }
+    }
+    for (const auto& songId : candidates) {
+        size_t hash = std::hash<std::string>()(songId);
+        Trend trend;
+        trend.songId = songId;
+        for (const Bucket* bucket : window) {
+            trend.weight += bucket->estimate(hash);
+        }
+        trends.push_back(trend);
+    }
+
+    size_t keep = std::min(limit, trends.size());
+    std::partial_sort(trends.begin(), trends.begin() + keep, trends.end(), [](const Trend& a, const Trend& b) {
+        return a.weight != b.weight ? a.weight > b.weight : a.songId < b.songId;
+    });
+    trends.resize(keep);
+    return trends;
+}
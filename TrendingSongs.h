@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Songs drawing the most votes right now, per event, over sliding windows of
+// up to MAX_WINDOW_MINUTES. Votes fall into one-minute buckets kept in a ring;
+// each bucket holds a Count-Min sketch of vote weight per song and a
+// SpaceSaving list of its heaviest songs. A window ranks the songs named by
+// its buckets' lists by their summed sketch estimates, so the memory per
+// event stays the same however many votes arrive. Estimates may run high but
+// never low; refunds and deletions are not taken back out.
+class TrendingSongs {
+public:
+    static const int MAX_WINDOW_MINUTES = 15;
+    static const size_t HEAVY_HITTERS = 32;
+    static const size_t SKETCH_DEPTH = 4;
+    static const size_t SKETCH_WIDTH = 512;
+
+    struct Trend {
+        std::string songId;
+        int weight = 0;
+    };
+
+    bool isLoaded() const { return loaded; }
+    void markLoaded() { loaded = true; }
+    void clear();
+
+    // Votes without a time, or older than the ring still holds, are skipped.
+    void add(const std::string& eventId, const std::string& songId, int weight, time_t voteTime);
+    // Up to limit songs with the most vote weight in the last minutes up to
+    // and including the minute of now, highest first.
+    std::vector<Trend> trending(const std::string& eventId, int minutes, time_t now, size_t limit) const;
+
+private:
+    struct HeavyHitter {
+        std::string songId;
+        int weight = 0;
+    };
+
+    struct Bucket {
+        long long minute = -1;
+        std::array<int, SKETCH_DEPTH * SKETCH_WIDTH> sketch{};
+        std::vector<HeavyHitter> heavy;
+
+        void reset(long long newMinute);
+        void add(const std::string& songId, size_t hash, int weight);
+        int estimate(size_t hash) const;
+    };
+
+    struct EventWindow {
+        std::array<Bucket, MAX_WINDOW_MINUTES> buckets;
+    };
+
+    bool loaded = false;
+    std::unordered_map<std::string, EventWindow> events;
+
+    static size_t column(size_t hash, size_t row);
+};
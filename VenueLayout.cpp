@@ -0,0 +1,112 @@
+#include "VenueLayout.h"
+#include <algorithm>
+#include <sstream>
+
+VenueLayout::VenueLayout(const Event& event)
+    : VenueLayout(event.sections.empty() ? defaultSections(event.totalSeats) : event.sections) {
+}
+
+VenueLayout::VenueLayout(std::vector<VenueSection> sectionList) : sections(std::move(sectionList)) {
+    rowStarts.reserve(sections.size() + 1);
+    seatStarts.reserve(sections.size() + 1);
+    rowStarts.push_back(0);
+    seatStarts.push_back(0);
+    for (const VenueSection& section : sections) {
+        int rows = std::max(section.rows, 0);
+        int seats = std::max(section.seatsPerRow, 0);
+        rowStarts.push_back(rowStarts.back() + rows);
+        seatStarts.push_back(seatStarts.back() + rows * seats);
+    }
+}
+
+std::vector<VenueSection> VenueLayout::defaultSections(int totalSeats) {
+    std::vector<VenueSection> result;
+    int fullRows = std::max(totalSeats, 0) / DEFAULT_SEATS_PER_ROW;
+    int remainder = std::max(totalSeats, 0) % DEFAULT_SEATS_PER_ROW;
+    if (fullRows > 0) {
+        result.push_back({ "Main", fullRows, DEFAULT_SEATS_PER_ROW });
+    }
+    if (remainder > 0) {
+        result.push_back({ "Main", 1, remainder });
+    }
+    return result;
+}
+
+bool VenueLayout::parse(const std::string& text, std::vector<VenueSection>& result) {
+    std::vector<VenueSection> parsed;
+    std::stringstream entries(text);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        size_t colon = entry.find(':');
+        size_t cross = entry.find_first_of("xX", colon == std::string::npos ? 0 : colon);
+        if (colon == std::string::npos || cross == std::string::npos) {
+            return false;
+        }
+
+        std::string name = entry.substr(0, colon);
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ') + 1);
+        std::string rowsText = entry.substr(colon + 1, cross - colon - 1);
+        std::string seatsText = entry.substr(cross + 1);
+        rowsText.erase(std::remove(rowsText.begin(), rowsText.end(), ' '), rowsText.end());
+        seatsText.erase(std::remove(seatsText.begin(), seatsText.end(), ' '), seatsText.end());
+
+        VenueSection section{ name, parseNumber(rowsText), parseNumber(seatsText) };
+        if (section.name.empty() || section.rows <= 0 || section.seatsPerRow <= 0) {
+            return false;
+        }
+        parsed.push_back(section);
+    }
+    if (parsed.empty()) {
+        return false;
+    }
+    result = std::move(parsed);
+    return true;
+}
+
+std::string VenueLayout::describe(const std::vector<VenueSection>& sectionList) {
+    std::string text;
+    for (const VenueSection& section : sectionList) {
+        if (!text.empty()) {
+            text += ", ";
+        }
+        text += section.name + ":" + std::to_string(section.rows) + "x" + std::to_string(section.seatsPerRow);
+    }
+    return text;
+}
+
+int VenueLayout::sectionOfRow(int row) const {
+    if (row < 1 || row > rowCount()) {
+        return -1;
+    }
+    // rowStarts is ascending; the section is the last one starting before row.
+    auto it = std::upper_bound(rowStarts.begin(), rowStarts.end(), row - 1);
+    return static_cast<int>(it - rowStarts.begin()) - 1;
+}
+
+int VenueLayout::seatsInRow(int row) const {
+    int index = sectionOfRow(row);
+    return index < 0 ? 0 : sections[index].seatsPerRow;
+}
+
+int VenueLayout::seatNumber(int row, int column) const {
+    int index = sectionOfRow(row);
+    if (index < 0 || column < 1 || column > sections[index].seatsPerRow) {
+        return -1;
+    }
+    return seatStarts[index] + (row - 1 - rowStarts[index]) * sections[index].seatsPerRow + (column - 1);
+}
+
+int VenueLayout::parseNumber(const std::string& text) {
+    if (text.empty() || text.size() > 9) {
+        return -1;
+    }
+    int value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return -1;
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Model.h"
+
+// Seat geometry of an event. Seats are numbered compactly from 0 in row-major
+// order across the sections, so a seat maps to one bit or array slot.
+class VenueLayout {
+public:
+    static const int DEFAULT_SEATS_PER_ROW = 10;
+
+    VenueLayout() = default;
+    explicit VenueLayout(const Event& event);
+    explicit VenueLayout(std::vector<VenueSection> sections);
+
+    // Sections for an event without a layout: rows of DEFAULT_SEATS_PER_ROW
+    // seats, with a shorter last row when totalSeats is not a multiple of it.
+    static std::vector<VenueSection> defaultSections(int totalSeats);
+
+    // Parses "Floor:20x50, Balcony:10x30"; returns false on malformed input.
+    static bool parse(const std::string& text, std::vector<VenueSection>& sections);
+    static std::string describe(const std::vector<VenueSection>& sections);
+
+    int capacity() const { return seatStarts.empty() ? 0 : seatStarts.back(); }
+    int rowCount() const { return rowStarts.empty() ? 0 : rowStarts.back(); }
+    size_t sectionCount() const { return sections.size(); }
+    const VenueSection& section(size_t index) const { return sections[index]; }
+    const std::vector<VenueSection>& allSections() const { return sections; }
+
+    // First venue row of a section (1-based) and its first seat number.
+    int firstRow(size_t index) const { return rowStarts[index] + 1; }
+    int lastRow(size_t index) const { return rowStarts[index + 1]; }
+    int firstSeat(size_t index) const { return seatStarts[index]; }
+
+    // Section holding the row, or -1 when the row is outside the venue.
+    int sectionOfRow(int row) const;
+    int seatsInRow(int row) const;
+
+    // Compact seat number of a 1-based row and column, or -1 when no such seat.
+    int seatNumber(int row, int column) const;
+    static int parseNumber(const std::string& text);
+
+    bool operator==(const VenueLayout& other) const { return sections == other.sections; }
+    bool operator!=(const VenueLayout& other) const { return !(*this == other); }
+
+private:
+    std::vector<VenueSection> sections;
+    std::vector<int> rowStarts;
+    std::vector<int> seatStarts;
+};
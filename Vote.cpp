@@ -1,4 +1,5 @@
 #include "Vote.h"
+#include "HyperLogLog.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -6,7 +7,10 @@
 #include <ctime>
 #include <iomanip>
 #include <set>
+#include <stdexcept>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace Voting {
 
@@ -141,10 +145,14 @@ namespace Voting {
 					break;
 				}
 			}
-			catch (...) {
+			catch (const std::logic_error&) {
 				output.println("Invalid input! Please enter a whole number only (1-6).", OutputManager::Color::RED);
 				system("pause");
 			}
+			catch (const std::exception& e) {
+				output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+				system("pause");
+			}
 		}
 	}
 
@@ -244,10 +252,14 @@ namespace Voting {
 					break;
 				}
 			}
-			catch (...) {
+			catch (const std::logic_error&) {
 				output.println("Invalid input! Please enter a whole number only (1-4).", OutputManager::Color::RED);
 				system("pause");
 			}
+			catch (const std::exception& e) {
+				output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+				system("pause");
+			}
 		}
 	}
 
@@ -273,15 +285,9 @@ namespace Voting {
 		output.printHeader("Voting Session");
 		Event event = getEventById(eventId);
 
-		auto votes = getActiveVotesForUser();
-		int votesAlreadyCast = 0;
-		for (const auto& vote : votes) {
-			if (vote.registrationId == registrationId) {
-				votesAlreadyCast++;
-			}
-		}
-
-		int remainingVotes = static_cast<int>(registration.seats.size()) - votesAlreadyCast;
+		VoteQuota::Entry quota = dm.getVoteQuota(registrationId);
+		int votesAlreadyCast = quota.used;
+		int remainingVotes = quota.remaining();
 
 		output.println("Event: " + event.eventName);
 		output.println("Registration ID: " + registrationId);
@@ -351,15 +357,18 @@ namespace Voting {
 				}
 
 				Vote vote;
-				vote.voteId = generateVoteId();
 				vote.songId = songs[songChoice].songId;
 				vote.registrationId = registrationId;
 				vote.voteWeight = 1;
 				vote.isDeleted = false;
+				vote.voteTime = time(nullptr);
 
-				auto allVotes = dm.getAllActiveVotes();
-				allVotes.push_back(vote);
-				dm.saveData(allVotes, dm.voteFileName);
+				std::string error;
+				if (!dm.castVote(vote, error)) {
+					output.println(error, OutputManager::Color::RED);
+					system("pause");
+					return;
+				}
 
 				output.println("Vote cast for: " + songs[songChoice].title + " by " + songs[songChoice].performer,
 					OutputManager::Color::GREEN);
@@ -370,13 +379,18 @@ namespace Voting {
 				}
 
 			}
-			catch (...) {
+			catch (const std::logic_error&) {
 				output.println("Invalid input! Please enter a whole number only (1-" +
 					std::to_string(songs.size()) + ").", OutputManager::Color::RED);
 				voteIndex--;
 				system("pause");
 				continue;
 			}
+			catch (const std::exception& e) {
+				output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+				system("pause");
+				return;
+			}
 		}
 
 		output.println("\n========================================");
@@ -485,11 +499,15 @@ namespace Voting {
 			processVotingForRegistration(selectedReg, currentDateTime);
 
 		}
-		catch (...) {
+		catch (const std::logic_error&) {
 			output.println("Invalid input! Please enter a whole number only (1-" +
 				std::to_string(eligibleRegistrations.size()) + ").", OutputManager::Color::RED);
 			system("pause");
 		}
+		catch (const std::exception& e) {
+			output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+			system("pause");
+		}
 	}
 
 	void VoteSystem::processVotingForRegistration(const Registration& registration, time_t currentDateTime) {
@@ -507,15 +525,9 @@ namespace Voting {
 		output.printHeader("Voting Session");
 		Event event = getEventById(registration.eventId);
 
-		auto votes = getActiveVotesForUser();
-		int votesAlreadyCast = 0;
-		for (const auto& vote : votes) {
-			if (vote.registrationId == registration.registrationId) {
-				votesAlreadyCast++;
-			}
-		}
-
-		int remainingVotes = static_cast<int>(registration.seats.size()) - votesAlreadyCast;
+		VoteQuota::Entry quota = dm.getVoteQuota(registration.registrationId);
+		int votesAlreadyCast = quota.used;
+		int remainingVotes = quota.remaining();
 
 		output.println("Event: " + event.eventName);
 		output.println("Registration ID: " + registration.registrationId);
@@ -578,15 +590,18 @@ namespace Voting {
 				}
 
 				Vote vote;
-				vote.voteId = generateVoteId();
 				vote.songId = songs[songChoice].songId;
 				vote.registrationId = registration.registrationId;
 				vote.voteWeight = 1;
 				vote.isDeleted = false;
+				vote.voteTime = time(nullptr);
 
-				auto allVotes = dm.getAllActiveVotes();
-				allVotes.push_back(vote);
-				dm.saveData(allVotes, dm.voteFileName);
+				std::string error;
+				if (!dm.castVote(vote, error)) {
+					output.println(error, OutputManager::Color::RED);
+					system("pause");
+					return;
+				}
 
 				output.println("Vote cast for: " + songs[songChoice].title + " by " + songs[songChoice].performer,
 					OutputManager::Color::GREEN);
@@ -597,11 +612,16 @@ namespace Voting {
 				}
 
 			}
-			catch (...) {
+			catch (const std::logic_error&) {
 				output.println("Invalid input! Please enter a whole number only.", OutputManager::Color::RED);
 				voteIndex--;
 				system("pause");
 			}
+			catch (const std::exception& e) {
+				output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+				system("pause");
+				return;
+			}
 		}
 
 		output.println("\n========================================");
@@ -663,32 +683,26 @@ namespace Voting {
 				system("pause");
 			}
 		}
-		catch (...) {
+		catch (const std::logic_error&) {
 			output.println("Invalid input! Please enter a whole number only (1-" +
 				std::to_string(eventsWithVotes.size() + 2) + ").", OutputManager::Color::RED);
 			system("pause");
 		}
+		catch (const std::exception& e) {
+			output.println(std::string("Error: ") + e.what(), OutputManager::Color::RED);
+			system("pause");
+		}
 	}
 
 	std::vector<std::pair<Event, int>> VoteSystem::getEventsWithVotes() {
 		std::vector<std::pair<Event, int>> eventsWithVotes;
-		auto votes = getActiveVotesForUser();
-		auto registrations = dm.getAllActiveRegistrations();
+		const VoteTally& tally = dm.getVoteTally();
 		auto events = dm.getAllActiveEvents();
 
-		std::map<std::string, int> votesPerEvent;
-		for (const auto& vote : votes) {
-			for (const auto& reg : registrations) {
-				if (reg.registrationId == vote.registrationId) {
-					votesPerEvent[reg.eventId]++;
-					break;
-				}
-			}
-		}
-
 		for (const auto& event : events) {
-			if (votesPerEvent[event.eventId] > 0) {
-				eventsWithVotes.push_back(std::make_pair(event, votesPerEvent[event.eventId]));
+			int votes = tally.totalVotes(event.eventId);
+			if (votes > 0) {
+				eventsWithVotes.push_back(std::make_pair(event, votes));
 			}
 		}
 
@@ -745,40 +759,29 @@ namespace Voting {
 	}
 
 	std::vector<VoteResult> VoteSystem::calculateVoteResultsForEvent(const std::string& eventId) {
-		auto votes = getActiveVotesForUser();
-		auto registrations = dm.getAllActiveRegistrations();
-		auto songs = loadSongsFromPerformancesForEvent(eventId);
-
-		std::vector<Vote> eventVotes;
-		for (const auto& vote : votes) {
-			for (const auto& reg : registrations) {
-				if (reg.registrationId == vote.registrationId && reg.eventId == eventId) {
-					eventVotes.push_back(vote);
-					break;
-				}
-			}
+		dm.getVoteTally();
+		std::vector<SongCounters::Count> counts;
+		DataManager::getVoteCounters().snapshot(eventId, counts);
+		std::unordered_map<std::string, SongCounters::Count> countBySong;
+		for (const auto& count : counts) {
+			countBySong[count.songId] = count;
 		}
+		auto songs = loadSongsFromPerformancesForEvent(eventId);
 
 		std::map<std::string, VoteResult> resultMap;
 
 		for (const auto& song : songs) {
+			const SongCounters::Count& count = countBySong[song.songId];
 			VoteResult result;
 			result.songId = song.songId;
 			result.title = song.title;
 			result.performer = song.performer;
-			result.totalVotes = 0;
-			result.totalVoteWeight = 0;
+			result.totalVotes = count.votes;
+			result.totalVoteWeight = count.weight;
 			result.percentage = 0.0;
 			resultMap[song.songId] = result;
 		}
 
-		for (const auto& vote : eventVotes) {
-			if (resultMap.find(vote.songId) != resultMap.end()) {
-				resultMap[vote.songId].totalVotes++;
-				resultMap[vote.songId].totalVoteWeight += vote.voteWeight;
-			}
-		}
-
 		int totalVoteWeight = 0;
 		for (const auto& pair : resultMap) {
 			totalVoteWeight += pair.second.totalVoteWeight;
@@ -813,30 +816,32 @@ namespace Voting {
 		int totalVotes = static_cast<int>(votes.size());
 		int totalVoteWeight = 0;
 		std::map<std::string, int> songVoteCount;
-		std::map<std::string, int> userVoteCount;
 
+		std::unordered_map<std::string, std::string> customerOfRegistration;
+		for (const auto& reg : dm.getAllActiveRegistrations()) {
+			customerOfRegistration[reg.registrationId] = reg.customerId;
+		}
+
+		// Sketched from the same filtered votes as the other figures; the
+		// lifetime AudienceCounts sketch would still count refunded voters.
+		HyperLogLog voters;
 		for (const auto& vote : votes) {
 			totalVoteWeight += vote.voteWeight;
 			songVoteCount[vote.songId]++;
-
-			auto registrations = dm.getAllActiveRegistrations();
-			for (const auto& reg : registrations) {
-				if (reg.registrationId == vote.registrationId) {
-					userVoteCount[reg.customerId]++;
-					break;
-				}
-			}
+			voters.add(customerOfRegistration[vote.registrationId]);
 		}
 
+		long long uniqueVoters = voters.count();
+
 		output.println("COMPREHENSIVE VOTING STATISTICS");
 		output.println("================================");
 		output.println("Total Votes Cast: " + std::to_string(totalVotes));
 		output.println("Total Vote Weight: " + std::to_string(totalVoteWeight));
-		output.println("Unique Voters: " + std::to_string(userVoteCount.size()));
+		output.println("Unique Voters (est.): " + std::to_string(uniqueVoters));
 		output.println("Songs Receiving Votes: " + std::to_string(songVoteCount.size()));
 
-		if (!userVoteCount.empty()) {
-			double avgVotesPerUser = static_cast<double>(totalVotes) / static_cast<double>(userVoteCount.size());
+		if (uniqueVoters > 0) {
+			double avgVotesPerUser = static_cast<double>(totalVotes) / static_cast<double>(uniqueVoters);
 			double avgWeightPerVote = static_cast<double>(totalVoteWeight) / static_cast<double>(totalVotes);
 			output.println("Average Votes per User: " + std::to_string(static_cast<int>(avgVotesPerUser)));
 
@@ -879,6 +884,37 @@ namespace Voting {
 				" (" + std::to_string(static_cast<int>(percentage)) + "%)");
 		}
 
+		output.println("\nTRENDING NOW");
+		output.println("============");
+
+		const TrendingSongs& trends = dm.getTrendingSongs();
+		time_t now = time(nullptr);
+		bool anyTrending = false;
+		for (const auto& eventData : getEventsWithVotes()) {
+			if (trends.trending(eventData.first.eventId, TrendingSongs::MAX_WINDOW_MINUTES, now, 1).empty()) {
+				continue;
+			}
+			anyTrending = true;
+			output.println(eventData.first.eventName + ":");
+			for (int minutes : { 1, 5, 15 }) {
+				std::string line;
+				for (const auto& trend : trends.trending(eventData.first.eventId, minutes, now, 3)) {
+					std::string songTitle = trend.songId;
+					for (const auto& song : songs) {
+						if (song.songId == trend.songId) {
+							songTitle = song.title;
+							break;
+						}
+					}
+					line += (line.empty() ? "" : ", ") + songTitle + " (" + std::to_string(trend.weight) + ")";
+				}
+				output.println("   Last " + std::to_string(minutes) + " min: " + (line.empty() ? "-" : line));
+			}
+		}
+		if (!anyTrending) {
+			output.println("No votes in the last 15 minutes.", OutputManager::Color::YELLOW);
+		}
+
 		system("pause");
 	}
 
@@ -1005,17 +1041,20 @@ namespace Voting {
 
 	std::vector<Vote> VoteSystem::getActiveVotesForUser() {
 		auto votes = dm.getAllActiveVotes();
-		auto registrations = dm.getAllActiveRegistrations();
-		std::vector<Vote> activeVotes;
+		std::unordered_set<std::string> countedRegistrations;
+		for (const auto& reg : dm.getAllActiveRegistrations()) {
+			countedRegistrations.insert(reg.registrationId);
+		}
+		for (const auto& payment : dm.getAllActivePayments()) {
+			if (payment.paymentStatus == PaymentStatus::REFUNDED) {
+				countedRegistrations.erase(payment.registrationId);
+			}
+		}
 
+		std::vector<Vote> activeVotes;
 		for (const auto& vote : votes) {
-			for (const auto& reg : registrations) {
-				if (reg.registrationId == vote.registrationId) {
-					if (!isRegistrationRefunded(reg.registrationId)) {
-						activeVotes.push_back(vote);
-					}
-					break;
-				}
+			if (countedRegistrations.count(vote.registrationId)) {
+				activeVotes.push_back(vote);
 			}
 		}
 
@@ -1090,29 +1129,7 @@ namespace Voting {
 	}
 
 	bool VoteSystem::hasAlreadyVoted(const std::string& registrationId) {
-		auto votes = getActiveVotesForUser();
-		auto registrations = dm.getAllActiveRegistrations();
-
-		int totalSeats = 0;
-		for (const auto& reg : registrations) {
-			if (reg.registrationId == registrationId) {
-				totalSeats = static_cast<int>(reg.seats.size());
-				break;
-			}
-		}
-
-		if (totalSeats == 0) {
-			return true;
-		}
-
-		int votesCount = 0;
-		for (const auto& vote : votes) {
-			if (vote.registrationId == registrationId) {
-				votesCount++;
-			}
-		}
-
-		return votesCount >= totalSeats;
+		return dm.getVoteQuota(registrationId).remaining() == 0;
 	}
 
 	void VoteSystem::displayRegistrations(const std::vector<Registration>& registrations) {
@@ -1165,29 +1182,29 @@ namespace Voting {
 	}
 
 	std::vector<VoteResult> VoteSystem::calculateVoteResults() {
-		auto votes = getActiveVotesForUser();
+		dm.getVoteTally();
+		std::vector<SongCounters::Count> counts;
+		DataManager::getVoteCounters().snapshot(VoteTally::ALL_EVENTS, counts);
+		std::unordered_map<std::string, SongCounters::Count> countBySong;
+		for (const auto& count : counts) {
+			countBySong[count.songId] = count;
+		}
 		auto songs = loadSongsFromPerformances();
 
 		std::map<std::string, VoteResult> resultMap;
 
 		for (const auto& song : songs) {
+			const SongCounters::Count& count = countBySong[song.songId];
 			VoteResult result;
 			result.songId = song.songId;
 			result.title = song.title;
 			result.performer = song.performer;
-			result.totalVotes = 0;
-			result.totalVoteWeight = 0;
+			result.totalVotes = count.votes;
+			result.totalVoteWeight = count.weight;
 			result.percentage = 0.0;
 			resultMap[song.songId] = result;
 		}
 
-		for (const auto& vote : votes) {
-			if (resultMap.find(vote.songId) != resultMap.end()) {
-				resultMap[vote.songId].totalVotes++;
-				resultMap[vote.songId].totalVoteWeight += vote.voteWeight;
-			}
-		}
-
 		int totalVoteWeight = 0;
 		for (const auto& pair : resultMap) {
 			totalVoteWeight += pair.second.totalVoteWeight;
@@ -1319,17 +1336,7 @@ namespace Voting {
 	}
 
 	Event VoteSystem::getEventById(const std::string& eventId) {
-		auto events = dm.getAllActiveEvents();
-		for (const auto& event : events) {
-			if (event.eventId == eventId) {
-				return event;
-			}
-		}
-		return Event();
-	}
-
-	std::string VoteSystem::generateVoteId() {
-		return dm.generateNewVoteId();
+		return dm.getEventFromEventId(eventId);
 	}
 
 }
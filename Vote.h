@@ -133,7 +133,6 @@ namespace Voting {
         void processVotingForRegistration(const Registration& registration, time_t currentDateTime);
 
         std::vector<VoteResult> calculateVoteResults();
-        std::string generateVoteId();
         Event getEventById(const std::string& eventId);
 
         std::vector<std::pair<Event, int>> getEventsWithVotes();
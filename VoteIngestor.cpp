@@ -0,0 +1,87 @@
+#include "VoteIngestor.h"
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+VoteIngestor::VoteIngestor(DataManager& dm, size_t maxBatch, std::chrono::milliseconds maxDelay, size_t capacity)
+    : dm(dm), maxBatch(maxBatch > 0 ? maxBatch : 1), maxDelay(maxDelay), capacity(capacity > 0 ? capacity : 1) {
+    committer = std::thread([this] { run(); });
+}
+
+VoteIngestor::~VoteIngestor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    notEmpty.notify_one();
+    committer.join();
+}
+
+std::future<VoteIngestor::Ack> VoteIngestor::submit(const Vote& vote) {
+    Pending pending;
+    pending.vote = vote;
+    std::future<Ack> ack = pending.ack.get_future();
+    bool wake;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return stopping || queue.size() < capacity; });
+        if (stopping) {
+            throw std::runtime_error("Vote ingestion has stopped.");
+        }
+        pending.queuedAt = std::chrono::steady_clock::now();
+        queue.push_back(std::move(pending));
+        // The first vote starts the group's clock; a full group goes at once.
+        wake = queue.size() == 1 || queue.size() >= maxBatch;
+    }
+    if (wake) {
+        notEmpty.notify_one();
+    }
+    return ack;
+}
+
+void VoteIngestor::run() {
+    for (;;) {
+        std::deque<Pending> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            auto deadline = queue.front().queuedAt + maxDelay;
+            notEmpty.wait_until(lock, deadline, [this] { return stopping || queue.size() >= maxBatch; });
+
+            size_t count = queue.size() < maxBatch ? queue.size() : maxBatch;
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        notFull.notify_all();
+        commit(batch);
+    }
+}
+
+void VoteIngestor::commit(std::deque<Pending>& batch) {
+    std::vector<Vote> votes;
+    votes.reserve(batch.size());
+    for (const auto& pending : batch) {
+        votes.push_back(pending.vote);
+    }
+
+    std::vector<std::string> errors;
+    try {
+        dm.castVotes(votes, errors);
+    }
+    catch (const std::exception& e) {
+        errors.assign(votes.size(), e.what());
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Ack ack;
+        ack.accepted = errors[i].empty();
+        ack.voteId = ack.accepted ? votes[i].voteId : "";
+        ack.error = errors[i];
+        batch[i].ack.set_value(ack);
+    }
+}
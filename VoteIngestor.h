@@ -0,0 +1,65 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Model.h"
+#include "DataManager.h"
+
+// Collects ballots from any number of threads and commits them in groups:
+// one committer thread saves up to maxBatch queued votes at a time through
+// DataManager::castVotes, so a burst pays for one lock, one refresh and one
+// journal append instead of one per ballot. A group is written once it is
+// full or its oldest vote has waited maxDelay; with a zero delay it is
+// whatever queued up while the previous group was written. Each submitter's
+// future is fulfilled after the group holding its vote is on disk: the group
+// is one journal append and one fsync, and when that write fails every vote
+// in the group is rejected with the error.
+//
+// The queue holds at most capacity votes; submit() blocks while it is full.
+// The destructor commits everything still queued before returning.
+class VoteIngestor {
+public:
+    struct Ack {
+        bool accepted = false;
+        std::string voteId;
+        std::string error;
+    };
+
+    static const size_t DEFAULT_BATCH = 256;
+    static const size_t DEFAULT_CAPACITY = 8192;
+
+    explicit VoteIngestor(DataManager& dm, size_t maxBatch = DEFAULT_BATCH,
+        std::chrono::milliseconds maxDelay = std::chrono::milliseconds(2), size_t capacity = DEFAULT_CAPACITY);
+    ~VoteIngestor();
+
+    VoteIngestor(const VoteIngestor&) = delete;
+    VoteIngestor& operator=(const VoteIngestor&) = delete;
+
+    std::future<Ack> submit(const Vote& vote);
+
+private:
+    struct Pending {
+        Vote vote;
+        std::promise<Ack> ack;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    DataManager& dm;
+    const size_t maxBatch;
+    const std::chrono::milliseconds maxDelay;
+    const size_t capacity;
+
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<Pending> queue;
+    bool stopping = false;
+    std::thread committer;
+
+    void run();
+    void commit(std::deque<Pending>& batch);
+};
@@ -0,0 +1,19 @@
+#include "VoteQuota.h"
+
+void VoteQuota::clear() {
+    entries.clear();
+    loaded = false;
+}
+
+void VoteQuota::setAllowed(const std::string& registrationId, int allowed) {
+    entries[registrationId].allowed = allowed;
+}
+
+void VoteQuota::addUsed(const std::string& registrationId, int change) {
+    entries[registrationId].used += change;
+}
+
+VoteQuota::Entry VoteQuota::entry(const std::string& registrationId) const {
+    auto it = entries.find(registrationId);
+    return it == entries.end() ? Entry() : it->second;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+
+// Votes each registration may cast (one per seat) and has cast so far. The
+// counts follow the registration and vote tables, so checking a ballot is a
+// single lookup instead of a scan over every vote.
+class VoteQuota {
+public:
+    struct Entry {
+        int allowed = 0;
+        int used = 0;
+
+        int remaining() const { return allowed > used ? allowed - used : 0; }
+    };
+
+    bool isLoaded() const { return loaded; }
+    void markLoaded() { loaded = true; }
+    void clear();
+
+    void setAllowed(const std::string& registrationId, int allowed);
+    void addUsed(const std::string& registrationId, int change);
+    Entry entry(const std::string& registrationId) const;
+
+private:
+    bool loaded = false;
+    std::unordered_map<std::string, Entry> entries;
+};
@@ -0,0 +1,158 @@
+#include "VoteTally.h"
+#include <algorithm>
+
+const std::string VoteTally::ALL_EVENTS = "*";
+
+void VoteTally::clear() {
+    events.clear();
+    songCounters.reset();
+    loaded = false;
+}
+
+void VoteTally::markLoaded() {
+    loaded = true;
+    songCounters.publish();
+}
+
+void VoteTally::add(const std::string& eventId, const std::string& songId, int weight) {
+    apply(eventId, songId, 1, weight);
+    apply(ALL_EVENTS, songId, 1, weight);
+}
+
+void VoteTally::remove(const std::string& eventId, const std::string& songId, int weight) {
+    apply(eventId, songId, -1, -weight);
+    apply(ALL_EVENTS, songId, -1, -weight);
+}
+
+const std::vector<VoteTally::SongCount>& VoteTally::top(const std::string& eventId) const {
+    static const std::vector<SongCount> none;
+    const EventTally* tally = find(eventId);
+    return tally ? tally->top : none;
+}
+
+VoteTally::SongCount VoteTally::count(const std::string& eventId, const std::string& songId) const {
+    const EventTally* tally = find(eventId);
+    if (tally) {
+        auto it = tally->songs.find(songId);
+        if (it != tally->songs.end()) {
+            return it->second;
+        }
+    }
+    SongCount empty;
+    empty.songId = songId;
+    return empty;
+}
+
+int VoteTally::totalVotes(const std::string& eventId) const {
+    const EventTally* tally = find(eventId);
+    return tally ? tally->votes : 0;
+}
+
+int VoteTally::totalWeight(const std::string& eventId) const {
+    const EventTally* tally = find(eventId);
+    return tally ? tally->weight : 0;
+}
+
+const VoteTally::EventTally* VoteTally::find(const std::string& eventId) const {
+    auto it = events.find(eventId);
+    return it == events.end() ? nullptr : &it->second;
+}
+
+void VoteTally::apply(const std::string& eventId, const std::string& songId, int votes, int weight) {
+    EventTally& tally = events[eventId];
+    auto slot = tally.counterSlots.find(songId);
+    if (slot == tally.counterSlots.end()) {
+        slot = tally.counterSlots.emplace(songId, songCounters.slot(eventId, songId)).first;
+    }
+    songCounters.add(slot->second, votes, weight);
+
+    SongCount& song = tally.songs[songId];
+    song.songId = songId;
+    song.votes += votes;
+    song.weight += weight;
+    tally.votes += votes;
+    tally.weight += weight;
+
+    if (votes > 0) {
+        promote(tally, song);
+    }
+    else {
+        SongCount changed = song;
+        if (song.votes <= 0) {
+            tally.songs.erase(songId);
+        }
+        demote(tally, changed);
+    }
+}
+
+bool VoteTally::ranksAbove(const SongCount& a, const SongCount& b) {
+    if (a.weight != b.weight) {
+        return a.weight > b.weight;
+    }
+    return a.songId < b.songId;
+}
+
+// Only this song gained, so it is the only one that can enter the list or
+// move up in it.
+void VoteTally::promote(EventTally& tally, const SongCount& song) {
+    std::vector<SongCount>& top = tally.top;
+    auto it = std::find_if(top.begin(), top.end(), [&](const SongCount& s) { return s.songId == song.songId; });
+    if (it != top.end()) {
+        *it = song;
+    }
+    else if (top.size() < TOP_K) {
+        top.push_back(song);
+        it = top.end() - 1;
+    }
+    else if (ranksAbove(song, top.back())) {
+        top.back() = song;
+        it = top.end() - 1;
+    }
+    else {
+        return;
+    }
+
+    while (it != top.begin() && ranksAbove(*it, *(it - 1))) {
+        std::iter_swap(it, it - 1);
+        --it;
+    }
+}
+
+// Only this song lost, so songs outside the list can only overtake it once it
+// has fallen to the last place; the list is rescanned just in that case.
+void VoteTally::demote(EventTally& tally, const SongCount& song) {
+    std::vector<SongCount>& top = tally.top;
+    auto it = std::find_if(top.begin(), top.end(), [&](const SongCount& s) { return s.songId == song.songId; });
+    if (it == top.end()) {
+        return;
+    }
+    bool outsiders = tally.songs.size() > top.size() - (song.votes <= 0 ? 1 : 0);
+    if (song.votes <= 0) {
+        top.erase(it);
+        if (outsiders) {
+            rebuildTop(tally);
+        }
+        return;
+    }
+
+    *it = song;
+    while (it + 1 != top.end() && ranksAbove(*(it + 1), *it)) {
+        std::iter_swap(it, it + 1);
+        ++it;
+    }
+    if (it + 1 == top.end() && outsiders) {
+        rebuildTop(tally);
+    }
+}
+
+void VoteTally::rebuildTop(EventTally& tally) {
+    std::vector<SongCount> songs;
+    songs.reserve(tally.songs.size());
+    for (const auto& entry : tally.songs) {
+        songs.push_back(entry.second);
+    }
+    size_t keep = songs.size() < TOP_K ? songs.size() : TOP_K;
+    std::partial_sort(songs.begin(), songs.begin() + keep, songs.end(), ranksAbove);
+    songs.resize(keep);
+    tally.top = std::move(songs);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SongCounters.h"
+
+// Running vote totals per event, updated one vote at a time so results never
+// rescan the votes. Every event also keeps its TOP_K songs in rank order: a
+// new vote moves its song at most TOP_K places, so the leaderboard costs the
+// same however many votes were cast. Totals over all events sit under
+// ALL_EVENTS.
+//
+// The per-song totals are mirrored into SongCounters, which other threads
+// may read without holding the store lock. The mirror is updated here, under
+// the store lock, and not after the lock is let go: whether a vote counts
+// depends on its registration and payments, and clear() resets the counters
+// for a rebuild, so a late add could land on totals already rebuilt with
+// it. Writers are serialized by the store anyway; what the counters save is
+// readers waiting for them.
+class VoteTally {
+public:
+    static const size_t TOP_K = 10;
+    static const std::string ALL_EVENTS;
+
+    struct SongCount {
+        std::string songId;
+        int votes = 0;
+        int weight = 0;
+    };
+
+    bool isLoaded() const { return loaded; }
+    void markLoaded();
+    void clear();
+
+    void add(const std::string& eventId, const std::string& songId, int weight);
+    void remove(const std::string& eventId, const std::string& songId, int weight);
+
+    // Highest weight first, ties broken by song id.
+    const std::vector<SongCount>& top(const std::string& eventId) const;
+    SongCount count(const std::string& eventId, const std::string& songId) const;
+    int totalVotes(const std::string& eventId) const;
+    int totalWeight(const std::string& eventId) const;
+    const SongCounters& counters() const { return songCounters; }
+
+private:
+    struct EventTally {
+        std::unordered_map<std::string, SongCount> songs;
+        std::vector<SongCount> top;
+        std::unordered_map<std::string, size_t> counterSlots;
+        int votes = 0;
+        int weight = 0;
+    };
+
+    bool loaded = false;
+    std::unordered_map<std::string, EventTally> events;
+    SongCounters songCounters;
+
+    const EventTally* find(const std::string& eventId) const;
+    void apply(const std::string& eventId, const std::string& songId, int votes, int weight);
+    static bool ranksAbove(const SongCount& a, const SongCount& b);
+    static void promote(EventTally& tally, const SongCount& song);
+    static void demote(EventTally& tally, const SongCount& song);
+    static void rebuildTop(EventTally& tally);
+};